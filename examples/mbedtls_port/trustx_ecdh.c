@@ -53,6 +53,7 @@ int mbedtls_ecdh_gen_public( mbedtls_ecp_group *grp, mbedtls_mpi *d, mbedtls_ecp
     size_t public_key_len = sizeof( public_key );
     optiga_ecc_curve_t curve_id;
     optiga_key_id_t optiga_key_id = OPTIGA_KEY_STORE_ID_E0F3;
+    uint16_t key_length = sizeof( public_key );
 
     //checking group against the supported curves of Optiga Trust X
     if ( ( grp->id != MBEDTLS_ECP_DP_SECP256R1 ) &&
@@ -63,17 +64,33 @@ int mbedtls_ecdh_gen_public( mbedtls_ecp_group *grp, mbedtls_mpi *d, mbedtls_ecp
 
 	grp->id == MBEDTLS_ECP_DP_SECP256R1 ? ( curve_id = OPTIGA_ECC_NIST_P_256 )
                                                 : ( curve_id = OPTIGA_ECC_NIST_P_384 );
+#ifdef OPTIGA_CRYPT_ECDH_POOL_SLOTS
+    //take a key pair prepared in a session context, the private key stays in OPTIGA and d only carries its session ID.
+    //with all slots in use the key pair is generated into E0F3, which d then carries.
+    status = optiga_crypt_ecdh_pool_acquire( curve_id, &optiga_key_id, public_key, &key_length );
+    if ( status != OPTIGA_LIB_SUCCESS )
+    {
+        return MBEDTLS_ERR_ECP_HW_ACCEL_FAILED;
+    }
+    if ( mbedtls_mpi_lset( d, optiga_key_id ) != 0 )
+    {
+        optiga_crypt_ecdh_pool_release( optiga_key_id );
+        return MBEDTLS_ERR_ECP_ALLOC_FAILED;
+    }
+#else
     //invoke optiga command to generate a key pair.
 	status = optiga_crypt_ecc_generate_keypair( curve_id,
                                                 (optiga_key_usage_t)( OPTIGA_KEY_USAGE_KEY_AGREEMENT | OPTIGA_KEY_USAGE_AUTHENTICATION ),
 												FALSE,
 												&optiga_key_id,
 												public_key,
-												(uint16_t *)&public_key_len ) ;
+												&key_length ) ;
 	if ( status != OPTIGA_LIB_SUCCESS )
     {
-		status = MBEDTLS_ERR_ECP_BAD_INPUT_DATA;
+		return MBEDTLS_ERR_ECP_HW_ACCEL_FAILED;
     }
+#endif
+    public_key_len = key_length;
 
     //store public key generated from optiga into mbedtls structure .
 	if ( mbedtls_ecp_point_read_binary( grp, Q,(unsigned char *)&public_key[3],(size_t )public_key_len-3 ) != 0 )
@@ -99,6 +116,16 @@ int mbedtls_ecdh_compute_shared( mbedtls_ecp_group *grp, mbedtls_mpi *z,
     uint8_t public_key_out[100];
     size_t public_key_length;
     uint8_t buf[100];
+    optiga_key_id_t optiga_key_id = OPTIGA_KEY_STORE_ID_E0F3;
+
+#ifdef OPTIGA_CRYPT_ECDH_POOL_SLOTS
+    //d carries the session ID of the key pair taken by mbedtls_ecdh_gen_public
+    if ( ( mbedtls_mpi_cmp_int( d, OPTIGA_SESSION_ID_E100 ) >= 0 ) &&
+         ( mbedtls_mpi_cmp_int( d, OPTIGA_SESSION_ID_E103 ) <= 0 ) )
+    {
+        optiga_key_id = (optiga_key_id_t)d->p[0];
+    }
+#endif
 
     //Step1: Prepare the public key material as expected by security chip
     //checking gid against the supported curves of OPTIGA Trust X
@@ -126,11 +153,16 @@ int mbedtls_ecdh_compute_shared( mbedtls_ecp_group *grp, mbedtls_mpi *z,
 		publickey.length = public_key_length + 3;
 
         //Invoke optiga command to generate shared secret and store in the OID/buffer.
-        status = optiga_crypt_ecdh(OPTIGA_KEY_STORE_ID_E0F3,
+        status = optiga_crypt_ecdh(optiga_key_id,
         						   &publickey,
         						   1,
                                    buf);
 
+#ifdef OPTIGA_CRYPT_ECDH_POOL_SLOTS
+        //the ephemeral key pair is used once, its slot is given back for the next handshake
+        optiga_crypt_ecdh_pool_release( optiga_key_id );
+#endif
+
         if ( status != OPTIGA_LIB_SUCCESS )
         {
             status = MBEDTLS_ERR_ECP_BAD_INPUT_DATA;
@@ -41,6 +41,28 @@
 
 #include "optiga/optiga_crypt.h"
 #include "optiga/optiga_util.h"
+#include "trustx_ecdsa.h"
+
+#if defined(MBEDTLS_ECDSA_VERIFY_ALT)
+#include "optiga/pal/pal_os_timer.h"
+#endif
+
+#if defined(MBEDTLS_ECDSA_VERIFY_ALT) || \
+    ( defined(MBEDTLS_SSL_ASYNC_PRIVATE) && defined(MBEDTLS_X509_CRT_PARSE_C) )
+#include "optiga/pal/pal_os_lock.h"
+#endif
+
+#if defined(MBEDTLS_PK_C)
+#include "mbedtls/pk_internal.h"
+
+#if defined(MBEDTLS_PLATFORM_C)
+#include "mbedtls/platform.h"
+#else
+#include <stdlib.h>
+#define mbedtls_calloc    calloc
+#define mbedtls_free       free
+#endif
+#endif
 
 #if defined(MBEDTLS_ECDSA_SIGN_ALT)
 
@@ -71,9 +93,12 @@ cleanup:
 
 
 #if defined(MBEDTLS_ECDSA_VERIFY_ALT)
-int mbedtls_ecdsa_verify( mbedtls_ecp_group *grp,
-                  const unsigned char *buf, size_t blen,
-                  const mbedtls_ecp_point *Q, const mbedtls_mpi *r, const mbedtls_mpi *s)
+/*
+ * Verify ECDSA signature on OPTIGA
+ */
+static int trustx_ecdsa_verify_chip( mbedtls_ecp_group *grp,
+                                     const unsigned char *buf, size_t blen,
+                                     const mbedtls_ecp_point *Q, const mbedtls_mpi *r, const mbedtls_mpi *s)
 {
 	optiga_lib_status_t status = OPTIGA_LIB_ERROR;
     public_key_from_host_t public_key;
@@ -137,6 +162,197 @@ int mbedtls_ecdsa_verify( mbedtls_ecp_group *grp,
 	
     return status;
 }
+/*
+ * Verify ECDSA signature on the host (SEC1 4.1.4), as mbedtls_ecdsa_verify does without the ALT
+ */
+static int trustx_ecdsa_verify_host( mbedtls_ecp_group *grp,
+                                     const unsigned char *buf, size_t blen,
+                                     const mbedtls_ecp_point *Q, const mbedtls_mpi *r, const mbedtls_mpi *s)
+{
+    int ret;
+    mbedtls_mpi e, s_inv, u1, u2;
+    mbedtls_ecp_point R;
+    size_t n_size = ( grp->nbits + 7 ) / 8;
+    size_t use_size = blen > n_size ? n_size : blen;
+
+    mbedtls_ecp_point_init( &R );
+    mbedtls_mpi_init( &e ); mbedtls_mpi_init( &s_inv ); mbedtls_mpi_init( &u1 ); mbedtls_mpi_init( &u2 );
+
+    if( grp->N.p == NULL )
+    {
+        return( MBEDTLS_ERR_ECP_BAD_INPUT_DATA );
+    }
+
+    //make sure r and s are in range 1..n-1
+    if( mbedtls_mpi_cmp_int( r, 1 ) < 0 || mbedtls_mpi_cmp_mpi( r, &grp->N ) >= 0 ||
+        mbedtls_mpi_cmp_int( s, 1 ) < 0 || mbedtls_mpi_cmp_mpi( s, &grp->N ) >= 0 )
+    {
+        ret = MBEDTLS_ERR_ECP_VERIFY_FAILED;
+        goto cleanup;
+    }
+    MBEDTLS_MPI_CHK( mbedtls_ecp_check_pubkey( grp, Q ) );
+
+    //derive the integer from the leftmost bits of the digest, reduced modulo n
+    MBEDTLS_MPI_CHK( mbedtls_mpi_read_binary( &e, buf, use_size ) );
+    if( use_size * 8 > grp->nbits )
+    {
+        MBEDTLS_MPI_CHK( mbedtls_mpi_shift_r( &e, use_size * 8 - grp->nbits ) );
+    }
+    if( mbedtls_mpi_cmp_mpi( &e, &grp->N ) >= 0 )
+    {
+        MBEDTLS_MPI_CHK( mbedtls_mpi_sub_mpi( &e, &e, &grp->N ) );
+    }
+
+    //u1 = e / s mod n, u2 = r / s mod n
+    MBEDTLS_MPI_CHK( mbedtls_mpi_inv_mod( &s_inv, s, &grp->N ) );
+    MBEDTLS_MPI_CHK( mbedtls_mpi_mul_mpi( &u1, &e, &s_inv ) );
+    MBEDTLS_MPI_CHK( mbedtls_mpi_mod_mpi( &u1, &u1, &grp->N ) );
+    MBEDTLS_MPI_CHK( mbedtls_mpi_mul_mpi( &u2, r, &s_inv ) );
+    MBEDTLS_MPI_CHK( mbedtls_mpi_mod_mpi( &u2, &u2, &grp->N ) );
+
+    //R = u1 G + u2 Q, the signature is valid if xR mod n is r
+    MBEDTLS_MPI_CHK( mbedtls_ecp_muladd( grp, &R, &u1, &grp->G, &u2, Q ) );
+    if( mbedtls_ecp_is_zero( &R ) )
+    {
+        ret = MBEDTLS_ERR_ECP_VERIFY_FAILED;
+        goto cleanup;
+    }
+    MBEDTLS_MPI_CHK( mbedtls_mpi_mod_mpi( &R.X, &R.X, &grp->N ) );
+    if( mbedtls_mpi_cmp_mpi( &R.X, r ) != 0 )
+    {
+        ret = MBEDTLS_ERR_ECP_VERIFY_FAILED;
+    }
+
+cleanup:
+    mbedtls_ecp_point_free( &R );
+    mbedtls_mpi_free( &e ); mbedtls_mpi_free( &s_inv ); mbedtls_mpi_free( &u1 ); mbedtls_mpi_free( &u2 );
+
+    return( ret );
+}
+
+static trustx_ecdsa_verify_policy_t verify_policy = TRUSTX_ECDSA_VERIFY_POLICY;
+//statistics of NIST P-256 and P-384, the curves supported by OPTIGA Trust X
+static trustx_ecdsa_verify_stats_t verify_stats[2];
+
+//verifications may run in several threads, the statistics are only touched in the critical section
+#ifdef PAL_OS_HAS_CRITICAL_SECTION
+#define TRUSTX_VERIFY_ENTER_CRITICAL()  pal_os_lock_enter_critical_section()
+#define TRUSTX_VERIFY_EXIT_CRITICAL()   pal_os_lock_exit_critical_section()
+#else
+#define TRUSTX_VERIFY_ENTER_CRITICAL()
+#define TRUSTX_VERIFY_EXIT_CRITICAL()
+#endif
+
+//Picks the backend of the next verification of the curve
+static trustx_ecdsa_verify_backend_t trustx_ecdsa_verify_select( trustx_ecdsa_verify_stats_t *stats )
+{
+    trustx_ecdsa_verify_backend_t slower;
+
+    if( verify_policy != TRUSTX_ECDSA_VERIFY_AUTO )
+    {
+        stats->backend = ( verify_policy == TRUSTX_ECDSA_VERIFY_HOST_ONLY ) ? TRUSTX_ECDSA_VERIFY_BACKEND_HOST
+                                                                            : TRUSTX_ECDSA_VERIFY_BACKEND_CHIP;
+        return( stats->backend );
+    }
+
+    //each backend is measured once before deciding
+    if( stats->host_count == 0 )
+    {
+        return( TRUSTX_ECDSA_VERIFY_BACKEND_HOST );
+    }
+    if( stats->chip_count == 0 )
+    {
+        return( TRUSTX_ECDSA_VERIFY_BACKEND_CHIP );
+    }
+
+    stats->backend = ( stats->host_latency <= stats->chip_latency ) ? TRUSTX_ECDSA_VERIFY_BACKEND_HOST
+                                                                    : TRUSTX_ECDSA_VERIFY_BACKEND_CHIP;
+    slower = ( stats->backend == TRUSTX_ECDSA_VERIFY_BACKEND_HOST ) ? TRUSTX_ECDSA_VERIFY_BACKEND_CHIP
+                                                                    : TRUSTX_ECDSA_VERIFY_BACKEND_HOST;
+
+    //the slower backend is measured again periodically, e.g. when OPTIGA was busy with other commands
+    return( ( ( stats->host_count + stats->chip_count ) % TRUSTX_ECDSA_VERIFY_PROBE_INTERVAL ) == 0 ? slower
+                                                                                                   : stats->backend );
+}
+
+//Averages the latency with a weight of 1/8 for the new sample, rounded to the nearest millisecond
+static void trustx_ecdsa_verify_record( uint32_t *count, uint32_t *latency, uint32_t sample )
+{
+    if( (*count)++ == 0 )
+    {
+        *latency = sample;
+    }
+    else
+    {
+        *latency = ( *latency * 7 + sample + 4 ) / 8;
+    }
+}
+
+int mbedtls_ecdsa_verify( mbedtls_ecp_group *grp,
+                  const unsigned char *buf, size_t blen,
+                  const mbedtls_ecp_point *Q, const mbedtls_mpi *r, const mbedtls_mpi *s)
+{
+    trustx_ecdsa_verify_stats_t *stats;
+    trustx_ecdsa_verify_backend_t backend;
+    uint32_t start_time;
+    uint32_t latency;
+    int ret;
+
+    //curves not supported by OPTIGA are always verified on the host
+    if ( ( grp->id != MBEDTLS_ECP_DP_SECP256R1 ) &&
+         ( grp->id != MBEDTLS_ECP_DP_SECP384R1 ) )
+    {
+        return( trustx_ecdsa_verify_host( grp, buf, blen, Q, r, s ) );
+    }
+    stats = &verify_stats[grp->id == MBEDTLS_ECP_DP_SECP256R1 ? 0 : 1];
+
+    TRUSTX_VERIFY_ENTER_CRITICAL();
+    backend = trustx_ecdsa_verify_select( stats );
+    TRUSTX_VERIFY_EXIT_CRITICAL();
+
+    start_time = pal_os_timer_get_time_in_milliseconds();
+    if( backend == TRUSTX_ECDSA_VERIFY_BACKEND_HOST )
+    {
+        ret = trustx_ecdsa_verify_host( grp, buf, blen, Q, r, s );
+    }
+    else
+    {
+        ret = trustx_ecdsa_verify_chip( grp, buf, blen, Q, r, s );
+    }
+    latency = pal_os_timer_get_time_in_milliseconds() - start_time;
+
+    TRUSTX_VERIFY_ENTER_CRITICAL();
+    if( backend == TRUSTX_ECDSA_VERIFY_BACKEND_HOST )
+    {
+        trustx_ecdsa_verify_record( &stats->host_count, &stats->host_latency, latency );
+    }
+    else
+    {
+        trustx_ecdsa_verify_record( &stats->chip_count, &stats->chip_latency, latency );
+    }
+    TRUSTX_VERIFY_EXIT_CRITICAL();
+
+    return( ret );
+}
+
+void trustx_ecdsa_verify_set_policy( trustx_ecdsa_verify_policy_t policy )
+{
+    verify_policy = policy;
+}
+
+void trustx_ecdsa_verify_get_stats( mbedtls_ecp_group_id gid, trustx_ecdsa_verify_stats_t *stats )
+{
+    if( gid == MBEDTLS_ECP_DP_SECP256R1 || gid == MBEDTLS_ECP_DP_SECP384R1 )
+    {
+        TRUSTX_VERIFY_ENTER_CRITICAL();
+        *stats = verify_stats[gid == MBEDTLS_ECP_DP_SECP256R1 ? 0 : 1];
+        TRUSTX_VERIFY_EXIT_CRITICAL();
+    }
+    else
+    {
+        memset( stats, 0, sizeof( *stats ) );
+    }
+}
 #endif
 
 #if defined(MBEDTLS_ECDSA_GENKEY_ALT)
@@ -182,6 +398,375 @@ int mbedtls_ecdsa_genkey( mbedtls_ecdsa_context *ctx, mbedtls_ecp_group_id gid,
 }					  
 #endif
 
+#if defined(MBEDTLS_PK_C)
+/*
+ * pk context of a key stored in OPTIGA, the public key comes first
+ * so that mbedtls_pk_ec() works on it as on a software EC key.
+ */
+typedef struct
+{
+    mbedtls_ecp_keypair keypair;
+    optiga_key_id_t key_id;
+} trustx_pk_context;
+
+static size_t trustx_pk_get_bitlen( const void *ctx )
+{
+    return( ( (const mbedtls_ecp_keypair *) ctx )->grp.pbits );
+}
+
+static int trustx_pk_can_do( mbedtls_pk_type_t type )
+{
+    //the private key is not available for ECDH
+    return( type == MBEDTLS_PK_ECKEY || type == MBEDTLS_PK_ECDSA );
+}
+
+static int trustx_pk_verify( void *ctx, mbedtls_md_type_t md_alg,
+                             const unsigned char *hash, size_t hash_len,
+                             const unsigned char *sig, size_t sig_len )
+{
+    int ret;
+    ((void) md_alg);
+
+    //the verification only needs the public key, it stays on the software path
+    ret = mbedtls_ecdsa_read_signature( (mbedtls_ecdsa_context *) ctx, hash, hash_len, sig, sig_len );
+    if( ret == MBEDTLS_ERR_ECP_SIG_LEN_MISMATCH )
+    {
+        return( MBEDTLS_ERR_PK_SIG_LEN_MISMATCH );
+    }
+
+    return( ret );
+}
+
+static int trustx_pk_sign( void *ctx, mbedtls_md_type_t md_alg,
+                           const unsigned char *hash, size_t hash_len,
+                           unsigned char *sig, size_t *sig_len,
+                           int (*f_rng)(void *, unsigned char *, size_t), void *p_rng )
+{
+    trustx_pk_context *trustx_ctx = (trustx_pk_context *) ctx;
+    uint8_t der_signature[MBEDTLS_ECDSA_MAX_LEN];
+    //room for the SEQUENCE tag and length in front of the components
+    unsigned char *p = der_signature + 4;
+    uint16_t dslen = sizeof( der_signature ) - 4;
+    size_t max_hash_len = ( trustx_ctx->keypair.grp.pbits + 7 ) / 8;
+    int ret;
+    ((void) md_alg);
+    ((void) f_rng);
+    ((void) p_rng);
+
+    // If the length of the digest is larger than
+    // key length of the group order, then truncate the digest to key length.
+    if ( hash_len > max_hash_len )
+    {
+        hash_len = max_hash_len;
+    }
+
+    //OPTIGA returns the R and S components as two DER INTEGERs, without the SEQUENCE
+    if ( optiga_crypt_ecdsa_sign( (uint8_t *) hash, (uint8_t) hash_len, trustx_ctx->key_id,
+                                  p, &dslen ) != OPTIGA_LIB_SUCCESS )
+    {
+        return( MBEDTLS_ERR_PK_HW_ACCEL_FAILED );
+    }
+
+    if( ( ret = mbedtls_asn1_write_len( &p, der_signature, dslen ) ) < 0 ||
+        ( ret = mbedtls_asn1_write_tag( &p, der_signature, MBEDTLS_ASN1_CONSTRUCTED | MBEDTLS_ASN1_SEQUENCE ) ) < 0 )
+    {
+        return( ret );
+    }
+    *sig_len = dslen + ( der_signature + 4 - p );
+    memcpy( sig, p, *sig_len );
+
+    return( 0 );
+}
+
+static int trustx_pk_check_pair( const void *pub, const void *prv )
+{
+    const mbedtls_ecp_keypair *pub_key = (const mbedtls_ecp_keypair *) pub;
+    const mbedtls_ecp_keypair *prv_key = (const mbedtls_ecp_keypair *) prv;
+
+    //the private key cannot be read from OPTIGA, only the public keys are compared
+    if( pub_key->grp.id != prv_key->grp.id ||
+        mbedtls_ecp_point_cmp( &pub_key->Q, &prv_key->Q ) != 0 )
+    {
+        return( MBEDTLS_ERR_ECP_BAD_INPUT_DATA );
+    }
+
+    return( 0 );
+}
+
+static void *trustx_pk_alloc( void )
+{
+    trustx_pk_context *ctx = mbedtls_calloc( 1, sizeof( trustx_pk_context ) );
+
+    if( ctx != NULL )
+    {
+        mbedtls_ecp_keypair_init( &ctx->keypair );
+    }
+
+    return( ctx );
+}
+
+static void trustx_pk_free( void *ctx )
+{
+    mbedtls_ecp_keypair_free( &( (trustx_pk_context *) ctx )->keypair );
+    mbedtls_free( ctx );
+}
+
+static void trustx_pk_debug( const void *ctx, mbedtls_pk_debug_item *items )
+{
+    items->type = MBEDTLS_PK_DEBUG_ECP;
+    items->name = "eckey.Q";
+    items->value = &( ( (mbedtls_ecp_keypair *) ctx )->Q );
+}
+
+static const mbedtls_pk_info_t trustx_pk_info = {
+    MBEDTLS_PK_ECKEY,
+    "TRUSTX",
+    trustx_pk_get_bitlen,
+    trustx_pk_can_do,
+    trustx_pk_verify,
+    trustx_pk_sign,
+    NULL,
+    NULL,
+    trustx_pk_check_pair,
+    trustx_pk_alloc,
+    trustx_pk_free,
+    trustx_pk_debug,
+};
+
+int mbedtls_trustx_pk_setup( mbedtls_pk_context *pk,
+                             const mbedtls_pk_context *public_key,
+                             optiga_key_id_t key_id )
+{
+    trustx_pk_context *trustx_ctx;
+    const mbedtls_ecp_keypair *public_keypair;
+    int ret;
+
+    if( public_key == NULL || !mbedtls_pk_can_do( public_key, MBEDTLS_PK_ECKEY ) )
+    {
+        return( MBEDTLS_ERR_PK_BAD_INPUT_DATA );
+    }
+    public_keypair = mbedtls_pk_ec( *public_key );
+
+    //checking group against the supported curves of Optiga Trust X
+    if ( ( public_keypair->grp.id != MBEDTLS_ECP_DP_SECP256R1 ) &&
+         ( public_keypair->grp.id != MBEDTLS_ECP_DP_SECP384R1 ) )
+    {
+        return( MBEDTLS_ERR_PK_FEATURE_UNAVAILABLE );
+    }
+
+    if( ( ret = mbedtls_pk_setup( pk, &trustx_pk_info ) ) != 0 )
+    {
+        return( ret );
+    }
+
+    trustx_ctx = (trustx_pk_context *) pk->pk_ctx;
+    trustx_ctx->key_id = key_id;
+    if( ( ret = mbedtls_ecp_group_copy( &trustx_ctx->keypair.grp, &public_keypair->grp ) ) != 0 ||
+        ( ret = mbedtls_ecp_copy( &trustx_ctx->keypair.Q, &public_keypair->Q ) ) != 0 )
+    {
+        mbedtls_pk_free( pk );
+    }
+
+    return( ret );
+}
+#endif
+
+#if defined(MBEDTLS_SSL_ASYNC_PRIVATE) && defined(MBEDTLS_X509_CRT_PARSE_C)
+//the completion runs in the OPTIGA event context while the connection may cancel the operation
+#ifndef PAL_OS_HAS_CRITICAL_SECTION
+#error "MBEDTLS_SSL_ASYNC_PRIVATE with OPTIGA requires PAL_OS_HAS_CRITICAL_SECTION, see pal_os_config.h"
+#endif
+#define TRUSTX_ASYNC_ENTER_CRITICAL()   pal_os_lock_enter_critical_section()
+#define TRUSTX_ASYNC_EXIT_CRITICAL()    pal_os_lock_exit_critical_section()
+
+typedef enum
+{
+    TRUSTX_ASYNC_IN_PROGRESS = 0,
+    TRUSTX_ASYNC_DONE,
+    TRUSTX_ASYNC_CANCELLED,
+} trustx_async_state_t;
+
+//Signature in flight for one connection
+typedef struct
+{
+    optiga_crypt_sign_request_t request;
+    //room for the SEQUENCE tag and length in front of the components
+    uint8_t der_signature[MBEDTLS_ECDSA_MAX_LEN];
+    uint16_t length;
+    optiga_lib_status_t status;
+    trustx_async_state_t state;
+    trustx_ssl_async_context *ctx;
+} trustx_async_operation;
+
+//Invoked from the OPTIGA event context
+static void trustx_ssl_async_done( void *p_ctx, optiga_lib_status_t status, uint16_t signature_length )
+{
+    trustx_async_operation *op = (trustx_async_operation *) p_ctx;
+    trustx_async_state_t state;
+    trustx_ssl_async_notify_t notify;
+    void *p_notify;
+
+    //once DONE is set, resume may free op at any time, so nothing of op is read after it
+    TRUSTX_ASYNC_ENTER_CRITICAL();
+    state = op->state;
+    notify = op->ctx->notify;
+    p_notify = op->ctx->p_notify;
+    if( state != TRUSTX_ASYNC_CANCELLED )
+    {
+        op->status = status;
+        op->length = signature_length;
+        op->state = TRUSTX_ASYNC_DONE;
+    }
+    TRUSTX_ASYNC_EXIT_CRITICAL();
+
+    if( state == TRUSTX_ASYNC_CANCELLED )
+    {
+        //the connection is gone, nobody owns the operation anymore
+        mbedtls_free( op );
+    }
+    else if( notify != NULL )
+    {
+        notify( p_notify );
+    }
+}
+
+static int trustx_ssl_async_sign( mbedtls_ssl_context *ssl, mbedtls_x509_crt *cert,
+                                  mbedtls_md_type_t md_alg,
+                                  const unsigned char *hash, size_t hash_len )
+{
+    trustx_ssl_async_context *ctx = (trustx_ssl_async_context *) mbedtls_ssl_conf_get_async_config_data( ssl->conf );
+    trustx_async_operation *op;
+    size_t max_hash_len;
+    size_t i;
+    ((void) md_alg);
+
+    for( i = 0; i < ctx->key_count; i++ )
+    {
+        if( ctx->keys[i].cert == cert )
+            break;
+    }
+    if( i == ctx->key_count || ! mbedtls_pk_can_do( &cert->pk, MBEDTLS_PK_ECKEY ) )
+    {
+        return( MBEDTLS_ERR_SSL_HW_ACCEL_FALLTHROUGH );
+    }
+
+    // If the length of the digest is larger than
+    // key length of the group order, then truncate the digest to key length.
+    max_hash_len = ( mbedtls_pk_ec( cert->pk )->grp.pbits + 7 ) / 8;
+    if ( hash_len > max_hash_len )
+    {
+        hash_len = max_hash_len;
+    }
+
+    if( ( op = mbedtls_calloc( 1, sizeof( trustx_async_operation ) ) ) == NULL )
+    {
+        return( MBEDTLS_ERR_SSL_ALLOC_FAILED );
+    }
+    op->state = TRUSTX_ASYNC_IN_PROGRESS;
+    op->ctx = ctx;
+    mbedtls_ssl_set_async_operation_data( ssl, op );
+
+    //OPTIGA returns the R and S components as two DER INTEGERs, without the SEQUENCE
+    if( optiga_crypt_ecdsa_sign_submit( &op->request, (uint8_t *) hash, (uint8_t) hash_len, ctx->keys[i].key_id,
+                                        op->der_signature + 4, sizeof( op->der_signature ) - 4,
+                                        trustx_ssl_async_done, op ) != OPTIGA_LIB_SUCCESS )
+    {
+        mbedtls_ssl_set_async_operation_data( ssl, NULL );
+        mbedtls_free( op );
+        return( MBEDTLS_ERR_PK_HW_ACCEL_FAILED );
+    }
+
+    return( MBEDTLS_ERR_SSL_ASYNC_IN_PROGRESS );
+}
+
+static int trustx_ssl_async_resume( mbedtls_ssl_context *ssl,
+                                    unsigned char *output, size_t *output_len, size_t output_size )
+{
+    trustx_async_operation *op = (trustx_async_operation *) mbedtls_ssl_get_async_operation_data( ssl );
+    unsigned char *p = op->der_signature + 4;
+    trustx_async_state_t state;
+    int ret;
+
+    TRUSTX_ASYNC_ENTER_CRITICAL();
+    state = op->state;
+    TRUSTX_ASYNC_EXIT_CRITICAL();
+    if( state != TRUSTX_ASYNC_DONE )
+    {
+        return( MBEDTLS_ERR_SSL_ASYNC_IN_PROGRESS );
+    }
+
+    if( op->status != OPTIGA_LIB_SUCCESS )
+    {
+        ret = MBEDTLS_ERR_PK_HW_ACCEL_FAILED;
+    }
+    else if( ( ret = mbedtls_asn1_write_len( &p, op->der_signature, op->length ) ) >= 0 &&
+             ( ret = mbedtls_asn1_write_tag( &p, op->der_signature, MBEDTLS_ASN1_CONSTRUCTED | MBEDTLS_ASN1_SEQUENCE ) ) >= 0 )
+    {
+        *output_len = op->length + ( op->der_signature + 4 - p );
+        if( *output_len > output_size )
+        {
+            ret = MBEDTLS_ERR_SSL_BUFFER_TOO_SMALL;
+        }
+        else
+        {
+            memcpy( output, p, *output_len );
+            ret = 0;
+        }
+    }
+
+    mbedtls_ssl_set_async_operation_data( ssl, NULL );
+    mbedtls_free( op );
+    return( ret );
+}
+
+static void trustx_ssl_async_cancel( mbedtls_ssl_context *ssl )
+{
+    trustx_async_operation *op = (trustx_async_operation *) mbedtls_ssl_get_async_operation_data( ssl );
+    trustx_async_state_t state;
+
+    //the request stays queued to OPTIGA, the completion frees the operation
+    TRUSTX_ASYNC_ENTER_CRITICAL();
+    state = op->state;
+    op->state = TRUSTX_ASYNC_CANCELLED;
+    TRUSTX_ASYNC_EXIT_CRITICAL();
+
+    if( state == TRUSTX_ASYNC_DONE )
+    {
+        mbedtls_free( op );
+    }
+    mbedtls_ssl_set_async_operation_data( ssl, NULL );
+}
+
+void trustx_ssl_async_init( trustx_ssl_async_context *ctx,
+                            trustx_ssl_async_notify_t notify, void *p_notify )
+{
+    memset( ctx, 0, sizeof( trustx_ssl_async_context ) );
+    ctx->notify = notify;
+    ctx->p_notify = p_notify;
+}
+
+int trustx_ssl_async_add_key( trustx_ssl_async_context *ctx,
+                              const mbedtls_x509_crt *cert, optiga_key_id_t key_id )
+{
+    if( ctx->key_count == TRUSTX_SSL_ASYNC_MAX_KEYS )
+    {
+        return( MBEDTLS_ERR_SSL_BAD_INPUT_DATA );
+    }
+
+    ctx->keys[ctx->key_count].cert = cert;
+    ctx->keys[ctx->key_count].key_id = key_id;
+    ctx->key_count++;
+
+    return( 0 );
+}
+
+void trustx_ssl_async_setup( mbedtls_ssl_config *conf, trustx_ssl_async_context *ctx )
+{
+    mbedtls_ssl_conf_async_private_cb( conf, trustx_ssl_async_sign, NULL,
+                                       trustx_ssl_async_resume, trustx_ssl_async_cancel, ctx );
+}
+#endif
+
 #endif
 /**
 * @}
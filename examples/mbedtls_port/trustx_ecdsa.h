@@ -0,0 +1,193 @@
+/**
+* MIT License
+*
+* Copyright (c) 2018 Infineon Technologies AG
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE
+*
+* @{
+*/
+
+#ifndef _TRUSTX_ECDSA_H_
+#define _TRUSTX_ECDSA_H_
+
+#include "mbedtls/pk.h"
+#include "optiga/optiga_crypt.h"
+
+#if defined(MBEDTLS_SSL_ASYNC_PRIVATE) && defined(MBEDTLS_X509_CRT_PARSE_C)
+#include "mbedtls/ssl.h"
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Policy of the ECDSA verification with MBEDTLS_ECDSA_VERIFY_ALT
+ */
+typedef enum
+{
+    TRUSTX_ECDSA_VERIFY_AUTO = 0,       /**< Verify on the backend measured as faster */
+    TRUSTX_ECDSA_VERIFY_HOST_ONLY,      /**< Always verify with mbedTLS on the host */
+    TRUSTX_ECDSA_VERIFY_CHIP_ONLY,      /**< Always verify on OPTIGA */
+} trustx_ecdsa_verify_policy_t;
+
+/**
+ * Backend of the ECDSA verification
+ */
+typedef enum
+{
+    TRUSTX_ECDSA_VERIFY_BACKEND_HOST = 0,
+    TRUSTX_ECDSA_VERIFY_BACKEND_CHIP,
+} trustx_ecdsa_verify_backend_t;
+
+/**
+ * Statistics of the ECDSA verification of a curve
+ */
+typedef struct
+{
+    trustx_ecdsa_verify_backend_t backend;  /**< Backend currently selected */
+    uint32_t host_count;                    /**< Number of verifications on the host */
+    uint32_t chip_count;                    /**< Number of verifications on OPTIGA */
+    uint32_t host_latency;                  /**< Average latency on the host in milliseconds */
+    uint32_t chip_latency;                  /**< Average latency on OPTIGA in milliseconds */
+} trustx_ecdsa_verify_stats_t;
+
+/** Policy applied from the start, TRUSTX_ECDSA_VERIFY_AUTO by default */
+#ifndef TRUSTX_ECDSA_VERIFY_POLICY
+#define TRUSTX_ECDSA_VERIFY_POLICY          TRUSTX_ECDSA_VERIFY_AUTO
+#endif
+
+/** With TRUSTX_ECDSA_VERIFY_AUTO, one in this number of verifications measures the slower backend again */
+#ifndef TRUSTX_ECDSA_VERIFY_PROBE_INTERVAL
+#define TRUSTX_ECDSA_VERIFY_PROBE_INTERVAL  64
+#endif
+
+#if defined(MBEDTLS_ECDSA_VERIFY_ALT)
+/**
+ * Sets the policy of mbedtls_ecdsa_verify.
+ *
+ * With TRUSTX_ECDSA_VERIFY_AUTO, the first verifications of a curve are run once on each backend,
+ * then each verification goes to the backend with the lower average latency. The latencies are
+ * measured with the millisecond PAL timer on the verifications themselves. Curves not supported by
+ * OPTIGA are always verified on the host. Without PAL_OS_HAS_CRITICAL_SECTION the statistics are not
+ * protected and mbedtls_ecdsa_verify must not be called from several threads at once.
+ *
+ * \param policy      Policy to apply to the next verifications
+ */
+void trustx_ecdsa_verify_set_policy( trustx_ecdsa_verify_policy_t policy );
+
+/**
+ * Gets the decision and the latencies observed for a curve.
+ *
+ * \param gid         MBEDTLS_ECP_DP_SECP256R1 or MBEDTLS_ECP_DP_SECP384R1, other curves give zeroed statistics
+ * \param stats       Statistics to fill
+ */
+void trustx_ecdsa_verify_get_stats( mbedtls_ecp_group_id gid, trustx_ecdsa_verify_stats_t *stats );
+#endif
+
+/**
+ * Sets up a pk context for a private key stored in OPTIGA Trust X.
+ *
+ * Only the keys set up with this function are signed by OPTIGA, all other keys stay on the
+ * mbedTLS software path, so MBEDTLS_ECDSA_SIGN_ALT should not be defined when it is used.
+ * The context can be passed to mbedtls_ssl_conf_own_cert().
+ *
+ * \param pk          Context to set up, initialized with mbedtls_pk_init()
+ * \param public_key  Context holding the public key of the OPTIGA key, e.g. from the device certificate
+ * \param key_id      OID of the private key in OPTIGA
+ *
+ * \return            0 on success, an MBEDTLS_ERR_xxx code otherwise
+ */
+int mbedtls_trustx_pk_setup( mbedtls_pk_context *pk,
+                             const mbedtls_pk_context *public_key,
+                             optiga_key_id_t key_id );
+
+#if defined(MBEDTLS_SSL_ASYNC_PRIVATE) && defined(MBEDTLS_X509_CRT_PARSE_C)
+/** Number of certificates whose key can be signed asynchronously */
+#ifndef TRUSTX_SSL_ASYNC_MAX_KEYS
+#define TRUSTX_SSL_ASYNC_MAX_KEYS           4
+#endif
+
+/**
+ * Callback invoked when an asynchronous signature completes, to wake up the
+ * server loop which then calls mbedtls_ssl_handshake() again for the connection.
+ * It is invoked from the OPTIGA event context and must not block.
+ */
+typedef void (*trustx_ssl_async_notify_t)( void *p_notify );
+
+/**
+ * Certificates signed by OPTIGA with the asynchronous callbacks
+ */
+typedef struct
+{
+    struct
+    {
+        const mbedtls_x509_crt *cert;   /**< Certificate passed to mbedtls_ssl_conf_own_cert() */
+        optiga_key_id_t key_id;         /**< OID of the private key in OPTIGA */
+    } keys[TRUSTX_SSL_ASYNC_MAX_KEYS];
+    size_t key_count;                   /**< Number of entries in keys */
+    trustx_ssl_async_notify_t notify;   /**< Completion callback, may be NULL */
+    void *p_notify;                     /**< Parameter of notify */
+} trustx_ssl_async_context;
+
+/**
+ * Initializes the context of the asynchronous signing.
+ *
+ * \param ctx         Context to initialize
+ * \param notify      Callback invoked when a signature completes, NULL to poll
+ * \param p_notify    Parameter of notify
+ */
+void trustx_ssl_async_init( trustx_ssl_async_context *ctx,
+                            trustx_ssl_async_notify_t notify, void *p_notify );
+
+/**
+ * Associates a certificate with a private key stored in OPTIGA Trust X.
+ *
+ * \param ctx         Context initialized with trustx_ssl_async_init()
+ * \param cert        Certificate also passed to mbedtls_ssl_conf_own_cert()
+ * \param key_id      OID of the private key in OPTIGA
+ *
+ * \return            0 on success, MBEDTLS_ERR_SSL_BAD_INPUT_DATA if the table is full
+ */
+int trustx_ssl_async_add_key( trustx_ssl_async_context *ctx,
+                              const mbedtls_x509_crt *cert, optiga_key_id_t key_id );
+
+/**
+ * Sets the asynchronous private key callbacks of a configuration.
+ *
+ * The handshakes of connections using a certificate of the context return
+ * MBEDTLS_ERR_SSL_ASYNC_IN_PROGRESS while OPTIGA signs, so that the server can
+ * go on with the other connections. The signatures are queued to OPTIGA with
+ * optiga_crypt_ecdsa_sign_submit(). The other certificates are signed in software.
+ *
+ * \param conf        SSL configuration
+ * \param ctx         Context, must stay valid as long as the configuration is used
+ */
+void trustx_ssl_async_setup( mbedtls_ssl_config *conf, trustx_ssl_async_context *ctx );
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _TRUSTX_ECDSA_H_ */
+/**
+* @}
+*/
@@ -19,6 +19,13 @@ int mbedtls_hardware_poll( void *data,
 
 	optiga_lib_status_t status = OPTIGA_LIB_ERROR;
 
+	//Provide at most the length supported by optiga_crypt_random, mbedtls polls again for the rest
+	if (len > 0xFFFF)
+	{
+		len = 0xFFFF;
+	}
+
+	//Served from the random pool if OPTIGA_CRYPT_RANDOM_POOL_SIZE is defined
 	status = optiga_crypt_random(eTRNG, output, len);
 	if ( status !=  OPTIGA_LIB_SUCCESS)
 	{
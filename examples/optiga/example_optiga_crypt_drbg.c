@@ -0,0 +1,85 @@
+/**
+* MIT License
+*
+* Copyright (c) 2018 Infineon Technologies AG
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE
+*
+*
+* \file example_optiga_crypt_drbg.c
+*
+* \brief   This file provides the example for generation of bulk random data using 
+*          #optiga_crypt_drbg_init, #optiga_crypt_drbg_generate and #optiga_crypt_drbg_free.
+*
+* \ingroup
+* @{
+*/
+
+#include "optiga/optiga_crypt.h"
+
+#ifdef OPTIGA_CRYPT_DRBG
+/**
+ * The below example demonstrates the generation of random data with a host DRBG
+ * seeded from the OPTIGA TRNG. Each thread uses its own DRBG instance.
+ *
+ * Example for #optiga_crypt_drbg_init, #optiga_crypt_drbg_generate, #optiga_crypt_drbg_free
+ *
+ */
+optiga_lib_status_t example_optiga_crypt_drbg(void)
+{
+    uint8_t random_data_buffer [1024];
+    const uint8_t personalization [] = {"example thread"};
+    optiga_crypt_drbg_t drbg;
+
+    optiga_lib_status_t return_status;
+
+    /**
+     * Seed the DRBG from the OPTIGA TRNG
+     */
+    return_status = optiga_crypt_drbg_init(&drbg, personalization, sizeof(personalization));
+    if (OPTIGA_LIB_SUCCESS != return_status)
+    {
+        return return_status;
+    }
+
+    do
+    {
+        /**
+         * Reseed after 64 KB of data or every 10 seconds
+         */
+        optiga_crypt_drbg_set_reseed_budget(&drbg, 0x10000, 10000);
+
+        return_status = optiga_crypt_drbg_generate(&drbg,
+                                                   random_data_buffer,
+                                                   sizeof(random_data_buffer));
+
+        if (OPTIGA_LIB_SUCCESS != return_status)
+        {
+            break;
+        }
+
+    } while(FALSE);
+
+    optiga_crypt_drbg_free(&drbg);
+    return return_status;
+}
+#endif
+/**
+* @}
+*/
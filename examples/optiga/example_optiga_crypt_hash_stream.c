@@ -0,0 +1,128 @@
+/**
+* MIT License
+*
+* Copyright (c) 2018 Infineon Technologies AG
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE
+*
+*
+* \file example_optiga_crypt_hash_stream.c
+*
+* \brief    This file provides the example for hashing a file using 
+*           #optiga_crypt_hash_start, #optiga_crypt_hash_update_stream and 
+*           #optiga_crypt_hash_finalize.
+*
+* \ingroup
+* @{
+*/
+
+#include <fcntl.h>
+#include <unistd.h>
+#include "optiga/optiga_crypt.h"
+
+/**
+ * Reads the next chunk of the file, a short read is only returned at the end of the file
+ */
+static optiga_lib_status_t example_file_source(void * p_ctx, uint8_t * p_buffer, uint16_t * p_length)
+{
+    int fd = *(int *)p_ctx;
+    uint16_t length = 0;
+    ssize_t bytes_read;
+
+    while (length < *p_length)
+    {
+        bytes_read = read(fd, p_buffer + length, *p_length - length);
+        if (bytes_read < 0)
+        {
+            return OPTIGA_LIB_ERROR;
+        }
+        if (0 == bytes_read)
+        {
+            break;
+        }
+        length += (uint16_t)bytes_read;
+    }
+    *p_length = length;
+    return OPTIGA_LIB_SUCCESS;
+}
+
+/**
+ * The below example demonstrates the generation of the digest of a file
+ * using optiga_crypt_hash_xxxx operations. The file is read while OPTIGA
+ * hashes the previously read data.
+ *
+ * Example for #optiga_crypt_hash_start, #optiga_crypt_hash_update_stream, 
+ * #optiga_crypt_hash_finalize
+ *
+ */
+optiga_lib_status_t example_optiga_crypt_hash_stream(const char_t * file_name)
+{
+    optiga_lib_status_t return_status = OPTIGA_LIB_ERROR;
+
+    uint8_t hash_context_buffer [130];
+    optiga_hash_context_t hash_context;
+
+    uint8_t digest [32];
+    int fd;
+
+    fd = open(file_name, O_RDONLY);
+    if (fd < 0)
+    {
+        return return_status;
+    }
+
+    do
+    {
+        hash_context.context_buffer = hash_context_buffer;
+        hash_context.context_buffer_length = sizeof(hash_context_buffer);
+        hash_context.hash_algo = OPTIGA_HASH_TYPE_SHA_256;
+
+        //Hash start
+        return_status = optiga_crypt_hash_start(&hash_context);
+        if(return_status != OPTIGA_LIB_SUCCESS)
+        {
+            break;
+        }
+
+        //Hash update with the content of the file
+        return_status = optiga_crypt_hash_update_stream(&hash_context,
+                                                        example_file_source,
+                                                        &fd);
+        if(return_status != OPTIGA_LIB_SUCCESS)
+        {
+            break;
+        }
+
+        // hash finalize
+        return_status = optiga_crypt_hash_finalize(&hash_context,
+                                                   digest);
+
+        if(return_status != OPTIGA_LIB_SUCCESS)
+        {
+            break;
+        }
+
+    } while(FALSE);
+
+    close(fd);
+    return return_status;
+}
+/**
+* @}
+*/
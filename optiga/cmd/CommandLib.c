@@ -38,6 +38,8 @@
 #ifdef USE_CMDLIB_WITH_RTOS
 #include "optiga/pal/pal_os_timer.h"
 #endif
+//Also brings the PAL_OS_HAS_xxx switches of pal_os_config.h
+#include "optiga/pal/pal_os_lock.h"
 
 /// @cond hidden
 
@@ -289,6 +291,31 @@ uint16_t wMaxCommsBuffer = INVALID_MAX_COMMS_BUFF_SIZE;
 ///ECC NIST P 384 Private key length
 #define ECC_NIST_P_384_KEY_LEN          48
 
+///Maximum number of payload segments sent from caller memory in one APDU
+#define MAX_APDU_PAYLOAD_SEGMENTS       6
+
+#if (CMDLIB_APDU_POOL_COUNT > 8)
+#error "CMDLIB_APDU_POOL_COUNT must not exceed 8"
+#endif
+
+///Bytes added to wMaxCommsBuffer for a pool buffer, covers the APDU header and OID in front of a full size response
+#define APDU_POOL_HEADROOM              8
+
+#ifdef PAL_OS_HAS_CRITICAL_SECTION
+///Protects the APDU buffer pool against concurrent callers
+#define CMDLIB_ENTER_CRITICAL()         pal_os_lock_enter_critical_section()
+#define CMDLIB_EXIT_CRITICAL()          pal_os_lock_exit_critical_section()
+#else
+#define CMDLIB_ENTER_CRITICAL()
+#define CMDLIB_EXIT_CRITICAL()
+#endif
+
+//APDU buffer pool, a single allocation holding CMDLIB_APDU_POOL_COUNT buffers of wApduPoolBufferSize bytes
+static uint8_t* pbApduPool = NULL;
+static uint16_t wApduPoolBufferSize = 0;
+//Bit n is set while buffer n is handed out
+static uint8_t bApduPoolInUse = 0;
+
 /**
  * Initializes the APDU buffer in stack.<br>
  **/
@@ -300,7 +327,7 @@ uint16_t wMaxCommsBuffer = INVALID_MAX_COMMS_BUFF_SIZE;
 }
 
 /**
- * Initializes the APDU buffer in heap.<br>
+ * Takes the APDU buffer from the APDU buffer pool (heap if the pool cannot serve it).<br>
  **/
 #define INIT_HEAP_APDUBUFFER(pbBuffer,wLen)					\
 {															\
@@ -309,7 +336,7 @@ uint16_t wMaxCommsBuffer = INVALID_MAX_COMMS_BUFF_SIZE;
 		i4Status = (int32_t)CMD_DEV_EXEC_ERROR;				\
         break;                                              \
 	}														\
-	pbBuffer = (uint8_t*)OCP_MALLOC(wLen);					\
+	pbBuffer = CmdLib_GetApduBuffer(wLen);					\
 	if(NULL == pbBuffer)									\
 	{														\
 		i4Status = (int32_t)CMD_LIB_INSUFFICIENT_MEMORY;	\
@@ -318,13 +345,13 @@ uint16_t wMaxCommsBuffer = INVALID_MAX_COMMS_BUFF_SIZE;
 }															\
 
 /**
- * Frees the heap memory.<br>
+ * Returns the APDU buffer to the pool.<br>
  **/
 #define FREE_HEAP_APDUBUFFER(pbBuffer)      \
 {											\
 	if(NULL != pbBuffer)					\
 	{										\
-		OCP_FREE(pbBuffer);					\
+		CmdLib_PutApduBuffer(pbBuffer);		\
 		pbBuffer = NULL;					\
 	}										\
 }
@@ -394,12 +421,41 @@ typedef enum eFragSeq_d
     eContinue = 0x02
 }eFragSeq_d;
 
+///Upper bound of a single wait for the completion notification, the completion flag is re-checked afterwards
+#define COMPLETION_WAIT_TIMEOUT_MS      100
+
 volatile static host_lib_status_t optiga_comms_status;
 
+///Function invoked while the security chip processes a command and its context
+static pFnWaitHook_d pfCmdLibWaitHook = NULL;
+static Void* pvCmdLibWaitHookCtx = NULL;
+
+///Owner of the hash context kept active in the security chip
+static Void* pvHashContextOwner = NULL;
+
 //lint --e{715, 818} suppress "This is ignored as app_event_handler_t handler function prototype requires this argument.This will be used for object based implementation"
 static void optiga_comms_event_handler(void* upper_layer_ctx, host_lib_status_t event)
 {
     optiga_comms_status = event;
+#ifdef PAL_OS_HAS_NOTIFICATION
+    pal_os_lock_notify();
+#endif
+}
+
+/**
+ * Waits until the comms event handler has reported the completion of the ongoing transceive.<br>
+ * Blocks on the PAL notification if available, otherwise polls the completion status.
+ */
+_STATIC_H void CmdLib_WaitForCompletion(void)
+{
+    while(optiga_comms_status == OPTIGA_COMMS_BUSY)
+    {
+#if defined(PAL_OS_HAS_NOTIFICATION)
+        (void)pal_os_lock_wait_for_notification(COMPLETION_WAIT_TIMEOUT_MS);
+#elif defined(USE_CMDLIB_WITH_RTOS)
+        pal_os_timer_delay_in_milliseconds(1);
+#endif
+    }
 }
 
 /**
@@ -433,11 +489,7 @@ _STATIC_H int32_t CmdLib_GetDeviceError(void)
         }
 
         //wait for completion
-        while(optiga_comms_status == OPTIGA_COMMS_BUSY){
-#ifdef USE_CMDLIB_WITH_RTOS
-        	pal_os_timer_delay_in_milliseconds(1);
-#endif
-        };
+        CmdLib_WaitForCompletion();
         if(optiga_comms_status != OPTIGA_COMMS_SUCCESS)
         {
             i4Status = (int32_t)CMD_DEV_EXEC_ERROR;
@@ -459,13 +511,19 @@ _STATIC_H int32_t CmdLib_GetDeviceError(void)
 
 
 /**
- * \brief Formats data as per Security Chip application and send using the communication functions.
+ * \brief Formats data as per Security Chip application and send using the communication functions.<br>
+ * If PpsPayload is provided, the payload is gathered from these segments after the APDU header in prgbAPDUBuffer,
+ * else the payload is taken from prgbAPDUBuffer.
  */
-_STATIC_H int32_t TransceiveAPDU(sApduData_d *PpsApduData,uint8_t bGetError)
+_STATIC_H int32_t TransceiveAPDUSegments(sApduData_d *PpsApduData, const sbBlob_d* PpsPayload,
+                                         uint8_t bPayloadCount, uint8_t bGetError)
 {  
     //lint --e{818} suppress "PpsResponse is out parameter"
     int32_t i4Status = (int32_t)CMD_LIB_ERROR;
     uint16_t wTotalLength;
+    sbBlob_d rgsTxSegments[1 + MAX_APDU_PAYLOAD_SEGMENTS];
+    sbBlob_d sRxSegment;
+    uint8_t bIndex;
     do
     {
         if(NULL == PpsApduData || NULL == p_optiga_comms)
@@ -473,6 +531,11 @@ _STATIC_H int32_t TransceiveAPDU(sApduData_d *PpsApduData,uint8_t bGetError)
             i4Status = (int32_t)CMD_LIB_NULL_PARAM;
             break;
         }
+        if(MAX_APDU_PAYLOAD_SEGMENTS < bPayloadCount)
+        { 
+            i4Status = (int32_t)CMD_LIB_INVALID_PARAM;
+            break;
+        }
         PpsApduData->prgbAPDUBuffer[OFFSET_CMD] = PpsApduData->bCmd;
         PpsApduData->prgbAPDUBuffer[OFFSET_PARAM] = PpsApduData->bParam;
 
@@ -483,22 +546,32 @@ _STATIC_H int32_t TransceiveAPDU(sApduData_d *PpsApduData,uint8_t bGetError)
         //update total length to consider total header length
         wTotalLength = PpsApduData->wPayloadLength + LEN_APDUHEADER;
 
+        //APDU header (and payload if not segmented) is sent from the APDU buffer, the payload segments follow
+        rgsTxSegments[0].prgbStream = PpsApduData->prgbAPDUBuffer;
+        rgsTxSegments[0].wLen = (0 == bPayloadCount)? wTotalLength : LEN_APDUHEADER;
+        for(bIndex = 0; bIndex < bPayloadCount; bIndex++)
+        {
+            rgsTxSegments[1 + bIndex] = PpsPayload[bIndex];
+        }
+        sRxSegment.prgbStream = PpsApduData->prgbRespBuffer;
+        sRxSegment.wLen = PpsApduData->wResponseLength;
+
         p_optiga_comms->upper_layer_handler = optiga_comms_event_handler;
         optiga_comms_status  = OPTIGA_COMMS_BUSY;
-        i4Status  =  optiga_comms_transceive(p_optiga_comms,PpsApduData->prgbAPDUBuffer,&wTotalLength,
-                                                PpsApduData->prgbRespBuffer,&PpsApduData->wResponseLength);
+        i4Status  =  optiga_comms_transceive_sg(p_optiga_comms,rgsTxSegments,(uint8_t)(1 + bPayloadCount),
+                                                &sRxSegment,1,&PpsApduData->wResponseLength);
         if(OPTIGA_COMMS_SUCCESS != i4Status)
         {
             i4Status = (int32_t)CMD_DEV_EXEC_ERROR;
             break;
         }
-        //wait for completion
-        do
+        //use the time the security chip needs to process the command
+        if(NULL != pfCmdLibWaitHook)
         {
-#ifdef USE_CMDLIB_WITH_RTOS
-        	pal_os_timer_delay_in_milliseconds(1);
-#endif
-        }while(optiga_comms_status == OPTIGA_COMMS_BUSY);
+            pfCmdLibWaitHook(pvCmdLibWaitHookCtx);
+        }
+        //wait for completion
+        CmdLib_WaitForCompletion();
         
         if(optiga_comms_status != OPTIGA_COMMS_SUCCESS)
         {
@@ -525,6 +598,52 @@ _STATIC_H int32_t TransceiveAPDU(sApduData_d *PpsApduData,uint8_t bGetError)
     return i4Status;
 }
 
+/**
+ * \brief Formats data as per Security Chip application and send using the communication functions.
+ */
+_STATIC_H int32_t TransceiveAPDU(sApduData_d *PpsApduData,uint8_t bGetError)
+{
+    return TransceiveAPDUSegments(PpsApduData, NULL, 0, bGetError);
+}
+
+/**
+ * \brief Allocates the APDU buffer pool with buffers sized from the maximum communication buffer size.<br>
+ * The pool is allocated once and kept across re-opening the application. If the allocation fails,
+ * the APDU buffers are taken from the heap per command as before.
+ */
+_STATIC_H void CmdLib_InitApduPool(void)
+{
+    uint16_t wBufferSize = wMaxCommsBuffer + APDU_POOL_HEADROOM;
+    uint8_t* pbPool;
+
+    if((NULL != pbApduPool) && (wApduPoolBufferSize >= wBufferSize))
+    {
+        return;
+    }
+
+    pbPool = (uint8_t*)OCP_MALLOC((size_t)wBufferSize * CMDLIB_APDU_POOL_COUNT);
+    if(NULL == pbPool)
+    {
+        return;
+    }
+
+    CMDLIB_ENTER_CRITICAL();
+    //A smaller pool is only replaced while none of its buffers is in use
+    if((NULL == pbApduPool) || (0 == bApduPoolInUse))
+    {
+        uint8_t* pbOldPool = pbApduPool;
+        pbApduPool = pbPool;
+        wApduPoolBufferSize = wBufferSize;
+        pbPool = pbOldPool;
+    }
+    CMDLIB_EXIT_CRITICAL();
+
+    if(NULL != pbPool)
+    {
+        OCP_FREE(pbPool);
+    }
+}
+
 /**
  * \brief Read the maximum size of communication buffer supported by the security chip by reading "Max comms buffer size" OID.
  */
@@ -806,6 +925,76 @@ _STATIC_H int32_t Get_KeySize(eAlgId_d PeAlgoIden,uint8_t* pbKeySize )
 
 /// @endcond
 
+/**
+* Takes a buffer for an APDU of wLen bytes from the APDU buffer pool.<br>
+* 
+* Notes:
+* - The pool is allocated by #CmdLib_OpenApplication with buffers of the maximum communication buffer size.<br>
+* - If wLen exceeds the pool buffer size or all pool buffers are in use, the buffer is allocated with OCP_MALLOC.<br>
+* - Can be called concurrently if PAL_OS_HAS_CRITICAL_SECTION is defined.<br>
+* 
+*\param[in] wLen Required buffer length in bytes
+*
+* \retval  Pointer to the buffer, NULL if no memory is available
+*/
+uint8_t* CmdLib_GetApduBuffer(uint16_t wLen)
+{
+    uint8_t* pbBuffer = NULL;
+    uint8_t bIndex;
+
+    CMDLIB_ENTER_CRITICAL();
+    if((NULL != pbApduPool) && (wLen <= wApduPoolBufferSize))
+    {
+        for(bIndex = 0; bIndex < CMDLIB_APDU_POOL_COUNT; bIndex++)
+        {
+            if(0 == (bApduPoolInUse & (1 << bIndex)))
+            {
+                bApduPoolInUse |= (uint8_t)(1 << bIndex);
+                pbBuffer = pbApduPool + ((size_t)bIndex * wApduPoolBufferSize);
+                break;
+            }
+        }
+    }
+    CMDLIB_EXIT_CRITICAL();
+
+    if(NULL == pbBuffer)
+    {
+        pbBuffer = (uint8_t*)OCP_MALLOC(wLen);
+    }
+    return pbBuffer;
+}
+
+/**
+* Returns a buffer taken with #CmdLib_GetApduBuffer.<br>
+* 
+*\param[in] pbBuffer Pointer to the buffer, NULL is ignored
+*/
+void CmdLib_PutApduBuffer(uint8_t* pbBuffer)
+{
+    uint8_t bFromPool = FALSE;
+    size_t dwOffset;
+
+    if(NULL == pbBuffer)
+    {
+        return;
+    }
+
+    CMDLIB_ENTER_CRITICAL();
+    if((NULL != pbApduPool) && (pbBuffer >= pbApduPool) &&
+       (pbBuffer < (pbApduPool + ((size_t)CMDLIB_APDU_POOL_COUNT * wApduPoolBufferSize))))
+    {
+        dwOffset = (size_t)(pbBuffer - pbApduPool);
+        bApduPoolInUse &= (uint8_t)~(1 << (dwOffset / wApduPoolBufferSize));
+        bFromPool = TRUE;
+    }
+    CMDLIB_EXIT_CRITICAL();
+
+    if(FALSE == bFromPool)
+    {
+        OCP_FREE(pbBuffer);
+    }
+}
+
 /**
 * Sets the OPTIGA Comms context provided by user application in the command libary.
 * 
@@ -820,6 +1009,45 @@ void CmdLib_SetOptigaCommsContext(const optiga_comms_t *p_input_optiga_comms)
 	p_optiga_comms = (optiga_comms_t*)p_input_optiga_comms;
 }
 
+/**
+* Sets the function invoked after a command is sent to the security chip and before its response is awaited.<br>
+* This allows the caller to prepare the next command while the security chip processes the current one.<br>
+* 
+* Notes:
+* - The hook must not call any command library API.<br>
+* - The hook is invoked for every command until it is reset by passing NULL.<br>
+* - With a synchronous communication stack the hook runs after the response is received.<br>
+* 
+*\param[in] pfWaitHook Function to invoke, NULL to remove the hook
+*\param[in] pvCtx Context passed to the hook
+*/
+void CmdLib_SetWaitHook(pFnWaitHook_d pfWaitHook, Void* pvCtx)
+{
+    pvCmdLibWaitHookCtx = pvCtx;
+    pfCmdLibWaitHook = pfWaitHook;
+}
+
+/**
+* Sets the owner of the hash context kept active in the security chip between hash commands.<br>
+* The owner is reset by #CmdLib_OpenApplication, as opening the application discards the active context.<br>
+* 
+*\param[in] pvOwner Owner of the active hash context, NULL if the active context has no owner
+*/
+void CmdLib_SetHashContextOwner(Void* pvOwner)
+{
+    pvHashContextOwner = pvOwner;
+}
+
+/**
+* Gets the owner of the hash context kept active in the security chip between hash commands.<br>
+* 
+* \retval  Owner set by #CmdLib_SetHashContextOwner, NULL if the active context has no owner
+*/
+Void* CmdLib_GetHashContextOwner(void)
+{
+    return pvHashContextOwner;
+}
+
 /**
 * Opens the Security Chip Application. The Unique Application Identifier is used internally by 
 * the function while forming a command APDU.
@@ -860,6 +1088,9 @@ int32_t CmdLib_OpenApplication(const sOpenApp_d* PpsOpenApp)
             break;
         }
 
+        //The hash context active in the security chip is discarded by opening the application
+        pvHashContextOwner = NULL;
+
         //Set the pointer to the response buffer
         sApduData.prgbRespBuffer = sApduData.prgbAPDUBuffer;
         //Open application command with MSB set to flush the last error code
@@ -879,7 +1110,12 @@ int32_t CmdLib_OpenApplication(const sOpenApp_d* PpsOpenApp)
         {
             //Get Maximum Comms buffer size
             i4Status = GetMaxCommsBuffer();
+            if(CMD_LIB_OK != i4Status)
+            {
+                break;
+            }
         }
+        CmdLib_InitApduPool();
     }while(FALSE);
 
 /// @cond hidden
@@ -1066,7 +1302,9 @@ int32_t CmdLib_GetDataObject(const sGetData_d *PpsGDVector, sCmdResponse_d *PpsR
 int32_t CmdLib_SetDataObject(const sSetData_d *PpsSDVector)
 {
 /// @cond hidden
-#define BUFFER_SIZE (wMaxCommsBuffer)
+#define OVERHEAD (OFFSET_PAYLOAD+BYTES_OID+BYTES_OFFSET)
+//Only the header, OID and offset are formed in the buffer followed by the response, data is sent from the caller buffer
+#define BUFFER_SIZE (OVERHEAD + LEN_APDUHEADER)
 /// @endcond
 
     int32_t i4Status = (int32_t)CMD_LIB_ERROR;
@@ -1074,6 +1312,7 @@ int32_t CmdLib_SetDataObject(const sSetData_d *PpsSDVector)
     uint16_t wWriteLen = 0;
     uint16_t wOffset;
     sApduData_d sApduData;
+    sbBlob_d rgsPayload[2];
     sApduData.prgbAPDUBuffer = NULL;
 
     do
@@ -1121,11 +1360,14 @@ int32_t CmdLib_SetDataObject(const sSetData_d *PpsSDVector)
         }
 
         //Set the pointer to the response buffer
-        sApduData.prgbRespBuffer = sApduData.prgbAPDUBuffer+7;
+        sApduData.prgbRespBuffer = sApduData.prgbAPDUBuffer + OVERHEAD;
         //copy OID
         sApduData.prgbAPDUBuffer[OFFSET_PAYLOAD] = (uint8_t)(PpsSDVector->wOID >> BITS_PER_BYTE);
         sApduData.prgbAPDUBuffer[OFFSET_PAYLOAD + 1] = (uint8_t)PpsSDVector->wOID;
         wOffset = PpsSDVector->wOffset;
+        //OID and offset are followed by the data in caller buffer
+        rgsPayload[0].prgbStream = sApduData.prgbAPDUBuffer + OFFSET_PAYLOAD;
+        rgsPayload[0].wLen = BYTES_OID + BYTES_OFFSET;
         do
         {
             //While chaining for erase & write option, all subsequent write must be only write operation
@@ -1134,10 +1376,6 @@ int32_t CmdLib_SetDataObject(const sSetData_d *PpsSDVector)
             {
                 sApduData.bParam = PARAM_SET_DATA;
             }
-/// @cond hidden
-#define OVERHEAD (OFFSET_PAYLOAD+BYTES_OID+BYTES_OFFSET)
-/// @endcond
-
             wWriteLen = MIN((wMaxCommsBuffer-OVERHEAD),(PpsSDVector->wLength-wTotalWriteLen));
            
             //set data payload length is 4(OID length + offset length) plus length of data to write
@@ -1146,14 +1384,14 @@ int32_t CmdLib_SetDataObject(const sSetData_d *PpsSDVector)
             //copy offset
             sApduData.prgbAPDUBuffer[OFFSET_PAYLOAD + BYTES_OID] = (uint8_t)(wOffset >> BITS_PER_BYTE);
             sApduData.prgbAPDUBuffer[OFFSET_PAYLOAD + BYTES_OID + 1] = (uint8_t)wOffset;                
-            //copy the data
-
-            OCP_MEMCPY(sApduData.prgbAPDUBuffer+OVERHEAD,PpsSDVector->prgbData+wTotalWriteLen,wWriteLen);
+            //the data is sent directly from the caller buffer
+            rgsPayload[1].prgbStream = PpsSDVector->prgbData + wTotalWriteLen;
+            rgsPayload[1].wLen = wWriteLen;
 
 			//Set Response buffer length
-			sApduData.wResponseLength = BUFFER_SIZE;
+			sApduData.wResponseLength = LEN_APDUHEADER;
 
-            i4Status = TransceiveAPDU(&sApduData,TRUE);
+            i4Status = TransceiveAPDUSegments(&sApduData,rgsPayload,2,TRUE);
             if(CMD_LIB_OK != i4Status)
             {
                 break;
@@ -1564,6 +1802,8 @@ int32_t CmdLib_CalcHash(sCalcHash_d* PpsCalcHash)
     uint16_t wOptTagOffset = 0;
     uint16_t wOffset;
     uint16_t wBufferLen;
+    uint16_t wInlineDataLen;
+    sbBlob_d rgsPayload[3];
        
     do
     {
@@ -1636,7 +1876,8 @@ int32_t CmdLib_CalcHash(sCalcHash_d* PpsCalcHash)
             {
                 wOptTagLen += CALC_HASH_IMPORT_OR_EXPORT_OVERHEAD_SIZE;
             }
-            wOptTagOffset = (eDataStream == PpsCalcHash->eHashDataType)? (OFFSET_PAYLOAD + BYTES_SEQ + BYTES_LENGTH + wInDataLen) : 
+            //Data stream is sent from the caller buffer, hence the optional tags follow the length in the APDU buffer
+            wOptTagOffset = (eDataStream == PpsCalcHash->eHashDataType)? (OFFSET_PAYLOAD + BYTES_SEQ + BYTES_LENGTH) : 
                                 (OFFSET_PAYLOAD + BYTES_SEQ + BYTES_LENGTH + INDATA_LEN_OID);
         }
         
@@ -1651,7 +1892,9 @@ int32_t CmdLib_CalcHash(sCalcHash_d* PpsCalcHash)
         sApduData.bCmd = CMD_CALCHASH;
         sApduData.bParam = (uint8_t)PpsCalcHash->eHashAlg;
         
-        wMemoryAllocLen = CALC_HASH_FIXED_OVERHEAD_SIZE + wInDataLen + wOptTagLen;
+        //Only the OID information is formed in the APDU buffer, data stream is not copied
+        wInlineDataLen = (eDataStream == eHashDataType)? 0 : wInDataLen;
+        wMemoryAllocLen = CALC_HASH_FIXED_OVERHEAD_SIZE + wInlineDataLen + wOptTagLen;
         
         wBufferLen = CALC_HASH_FIXED_OVERHEAD_SIZE;
         
@@ -1682,13 +1925,8 @@ int32_t CmdLib_CalcHash(sCalcHash_d* PpsCalcHash)
             
         if(eTerminateHash != PpsCalcHash->eHashSequence)
         {
-			//If the DataType is Data stream, copy the input data to the buffer
-            if(eDataStream == eHashDataType)
-            {
-                OCP_MEMCPY(&sApduData.prgbAPDUBuffer[OFFSET_PAYLOAD + BYTES_SEQ + BYTES_LENGTH], PpsCalcHash->sDataStream.prgbStream, 
-                wInDataLen);
-            }
-            else
+			//If the DataType is Data stream, the input data is sent from the caller buffer
+            if(eDataStream != eHashDataType)
             {
                 //If the Data type is OID, copy the OID information to the buffer 
                 sApduData.prgbAPDUBuffer[OFFSET_PAYLOAD + BYTES_SEQ + BYTES_LENGTH] = (uint8_t)(PpsCalcHash->sOIDData.wOID >> 8);
@@ -1732,7 +1970,15 @@ int32_t CmdLib_CalcHash(sCalcHash_d* PpsCalcHash)
         
         sApduData.wResponseLength = wMemoryAllocLen;
         
-        i4Status = TransceiveAPDU(&sApduData,TRUE);
+        //Sequence and length, data stream from caller buffer and then the optional tags
+        rgsPayload[0].prgbStream = sApduData.prgbAPDUBuffer + OFFSET_PAYLOAD;
+        rgsPayload[0].wLen = BYTES_SEQ + BYTES_LENGTH + wInlineDataLen;
+        rgsPayload[1].prgbStream = (eDataStream == eHashDataType)? PpsCalcHash->sDataStream.prgbStream : NULL;
+        rgsPayload[1].wLen = wInDataLen - wInlineDataLen;
+        rgsPayload[2].prgbStream = sApduData.prgbAPDUBuffer + OFFSET_PAYLOAD + rgsPayload[0].wLen;
+        rgsPayload[2].wLen = wOptTagLen;
+
+        i4Status = TransceiveAPDUSegments(&sApduData,rgsPayload,3,TRUE);
         if(CMD_LIB_OK != i4Status)
         {
             break;
@@ -1839,6 +2085,8 @@ int32_t CmdLib_VerifySign(const sVerifyOption_d* PpsVerifySign,const sbBlob_d *
 	sApduData_d sApduData = {0};
     uint16_t wWritePosition = OFFSET_PAYLOAD;
     uint16_t wCalApduLen = 0;
+    sbBlob_d rgsPayload[6];
+    uint8_t bPayloadCount;
     
 /// @cond hidden
 	///Minimum length of APDU InData in case of Public Key from Host. [TLV Header(3) for Digest + TLV Header (3) for Signature + TLV Header(3) for Public Key + TLV for Algo (4)]
@@ -1870,30 +2118,41 @@ int32_t CmdLib_VerifySign(const sVerifyOption_d* PpsVerifySign,const sbBlob_d *
         {
             wCalApduLen = OFFSET_PAYLOAD + OID_APDU_INDATA_LEN + PpsDigest->wLen + PpsSignature->wLen;
         }
+        if(0 == wCalApduLen)
+        {
+            i4Status = (int32_t)CMD_LIB_INVALID_PARAM;
+            break;
+        }
         if((wMaxCommsBuffer) < wCalApduLen)
         {
             i4Status = (int32_t)CMD_LIB_INSUFFICIENT_MEMORY;
             break;
         }
 
-        //Allocating Heap memory 
-        INIT_HEAP_APDUBUFFER(sApduData.prgbAPDUBuffer,wCalApduLen);
+        //Allocating Heap memory, only the tags and lengths are formed in the buffer. 
+        //Digest, signature and public key are sent from the caller buffers.
+        INIT_HEAP_APDUBUFFER(sApduData.prgbAPDUBuffer,(OFFSET_PAYLOAD + DATA_STREAM_APDU_INDATA_LEN));
 
         //Set the pointer to the response buffer
         sApduData.prgbRespBuffer = sApduData.prgbAPDUBuffer;
-				sApduData.wResponseLength = wMaxCommsBuffer;
+        sApduData.wResponseLength = OFFSET_PAYLOAD + DATA_STREAM_APDU_INDATA_LEN;
         //Set digest tag, length, data
-        sApduData.prgbAPDUBuffer[OFFSET_PAYLOAD] = TAG_DIGEST;
+        sApduData.prgbAPDUBuffer[wWritePosition] = TAG_DIGEST;
         Utility_SetUint16(&sApduData.prgbAPDUBuffer[wWritePosition + TAG_LENGTH_OFFSET], PpsDigest->wLen);
-        OCP_MEMCPY(&sApduData.prgbAPDUBuffer[wWritePosition + TAG_VALUE_OFFSET],PpsDigest->prgbStream,PpsDigest->wLen);
-        wWritePosition += TAG_VALUE_OFFSET+ PpsDigest->wLen;
+        rgsPayload[0].prgbStream = &sApduData.prgbAPDUBuffer[wWritePosition];
+        rgsPayload[0].wLen = TAG_VALUE_OFFSET;
+        rgsPayload[1] = *PpsDigest;
+        wWritePosition += TAG_VALUE_OFFSET;
 
         //Set signature tag, length, data
         sApduData.prgbAPDUBuffer[wWritePosition] = TAG_SIGNATURE;
         Utility_SetUint16(&sApduData.prgbAPDUBuffer[wWritePosition + TAG_LENGTH_OFFSET], PpsSignature->wLen);
-        OCP_MEMCPY(&sApduData.prgbAPDUBuffer[wWritePosition + TAG_VALUE_OFFSET],PpsSignature->prgbStream,PpsSignature->wLen);
-        wWritePosition += TAG_VALUE_OFFSET + PpsSignature->wLen;
-
+        rgsPayload[2].prgbStream = &sApduData.prgbAPDUBuffer[wWritePosition];
+        rgsPayload[2].wLen = TAG_VALUE_OFFSET;
+        rgsPayload[3] = *PpsSignature;
+        wWritePosition += TAG_VALUE_OFFSET;
+        rgsPayload[4].prgbStream = &sApduData.prgbAPDUBuffer[wWritePosition];
+        bPayloadCount = 5;
 
         if(eDataStream == PpsVerifySign->eVerifyDataType)
         {
@@ -1905,10 +2164,9 @@ int32_t CmdLib_VerifySign(const sVerifyOption_d* PpsVerifySign,const sbBlob_d *
 
             sApduData.prgbAPDUBuffer[wWritePosition + TAG_VALUE_OFFSET + BYTES_SEQ] = (uint8_t)TAG_PUB_KEY;
             Utility_SetUint16(&sApduData.prgbAPDUBuffer[wWritePosition + TAG_VALUE_OFFSET + BYTES_OFFSET], PpsVerifySign->sPubKeyInput.sDataStream.wLen);
-            wWritePosition += TAG_VALUE_OFFSET + BYTES_OFFSET + BYTES_OFFSET;
-            OCP_MEMCPY(&sApduData.prgbAPDUBuffer[wWritePosition],PpsVerifySign->sPubKeyInput.sDataStream.prgbStream ,PpsVerifySign->sPubKeyInput.sDataStream.wLen);
-            //Total payload length
-            sApduData.wPayloadLength = (uint16_t)(wWritePosition + PpsVerifySign->sPubKeyInput.sDataStream.wLen - OFFSET_PAYLOAD);
+            rgsPayload[4].wLen = TAG_VALUE_OFFSET + BYTES_OFFSET + BYTES_OFFSET;
+            rgsPayload[5] = PpsVerifySign->sPubKeyInput.sDataStream;
+            bPayloadCount = 6;
         }
 
         if(eOIDData == PpsVerifySign->eVerifyDataType)
@@ -1917,17 +2175,19 @@ int32_t CmdLib_VerifySign(const sVerifyOption_d* PpsVerifySign,const sbBlob_d *
             sApduData.prgbAPDUBuffer[wWritePosition] = TAG_PUB_KEY_OID;
             Utility_SetUint16(&sApduData.prgbAPDUBuffer[wWritePosition + TAG_LENGTH_OFFSET], LEN_PUB_KEY);
             Utility_SetUint16(&sApduData.prgbAPDUBuffer[wWritePosition + TAG_VALUE_OFFSET], PpsVerifySign->wOIDPubKey);
-            //Total payload length 
-            sApduData.wPayloadLength = (uint16_t)(wWritePosition + TAG_VALUE_OFFSET + BYTES_OFFSET - OFFSET_PAYLOAD);
+            rgsPayload[4].wLen = TAG_VALUE_OFFSET + BYTES_OFFSET;
         }
 
+        //Total payload length 
+        sApduData.wPayloadLength = (uint16_t)(wCalApduLen - OFFSET_PAYLOAD);
+
         //Form Command
         sApduData.bCmd = CMD_VERIFYSIGN;
         sApduData.bParam = (uint8_t)PpsVerifySign->eSignScheme;
 
 
         //Transmit data
-        i4Status = TransceiveAPDU(&sApduData,TRUE);
+        i4Status = TransceiveAPDUSegments(&sApduData,rgsPayload,bPayloadCount,TRUE);
         if(CMD_LIB_OK != i4Status)
         {
             break;
@@ -2215,6 +2475,186 @@ int32_t CmdLib_CalculateSign(const sCalcSignOptions_d *PpsCalcSign,sbBlob_d *Pps
     return i4Status;
 }
 
+_STATIC_H Void CmdLib_SignRequestHandler(Void* pvCtx, host_lib_status_t wEvent);
+
+/**
+ * \brief Queues the read of the error code object in the APDU buffer of a failed signature request.
+ */
+_STATIC_H int32_t CmdLib_SubmitGetDeviceError(sCmdLibSignRequest_d* psRequest)
+{
+    psRequest->rgbApdu[OFFSET_CMD] = CMD_GETDATA;
+    psRequest->rgbApdu[OFFSET_PARAM] = 0x00;
+    Utility_SetUint16(&psRequest->rgbApdu[OFFSET_LENGTH], 0x02);
+    Utility_SetUint16(&psRequest->rgbApdu[OFFSET_PAYLOAD], OID_ERROR);
+
+    psRequest->sTxSegment.wLen = (uint16_t)(LEN_APDUHEADER + 0x02);
+    psRequest->sRxSegment.wLen = sizeof(psRequest->rgbApdu);
+    psRequest->bReadError = TRUE;
+
+    if(OPTIGA_COMMS_SUCCESS != optiga_comms_submit(p_optiga_comms, &psRequest->sCommsRequest))
+    {
+        return (int32_t)CMD_DEV_EXEC_ERROR;
+    }
+    return (int32_t)CMD_LIB_OK;
+}
+
+/**
+ * \brief Completes a signature request queued with #CmdLib_SubmitCalculateSign.
+ */
+_STATIC_H Void CmdLib_SignRequestHandler(Void* pvCtx, host_lib_status_t wEvent)
+{
+    sCmdLibSignRequest_d* psRequest = (sCmdLibSignRequest_d*)pvCtx;
+    int32_t i4Status = (int32_t)CMD_LIB_OK;
+    uint16_t wRespLen = psRequest->sCommsRequest.rx_length;
+    bool_t bComplete = TRUE;
+
+    do
+    {
+        if((OPTIGA_COMMS_SUCCESS != wEvent) || (LEN_APDUHEADER > wRespLen))
+        {
+            i4Status = (int32_t)CMD_DEV_EXEC_ERROR;
+            break;
+        }
+        //Response of the error code object, as returned by CmdLib_GetDeviceError
+        if(TRUE == psRequest->bReadError)
+        {
+            i4Status = (int32_t)CMD_DEV_EXEC_ERROR;
+            if(0 == psRequest->rgbApdu[OFFSET_RESP_STATUS])
+            {
+                i4Status = (int32_t)CMD_DEV_ERROR;
+                if(LEN_APDUHEADER < wRespLen)
+                {
+                    i4Status |= psRequest->rgbApdu[OFFSET_PAYLOAD];
+                }
+            }
+            break;
+        }
+        //The error code is read by a request queued behind the ones already submitted, which completes this one
+        if(0 != psRequest->rgbApdu[OFFSET_RESP_STATUS])
+        {
+            i4Status = CmdLib_SubmitGetDeviceError(psRequest);
+            if((int32_t)CMD_LIB_OK == i4Status)
+            {
+                bComplete = FALSE;
+            }
+            break;
+        }
+        wRespLen -= LEN_APDUHEADER;
+        if(wRespLen > psRequest->psSignature->wLen)
+        {
+            i4Status = (int32_t)CMD_LIB_INSUFFICIENT_MEMORY;
+            break;
+        }
+        //Copy signature to output buffer
+        OCP_MEMCPY(psRequest->psSignature->prgbStream,&psRequest->rgbApdu[LEN_APDUHEADER],wRespLen);
+        psRequest->psSignature->wLen = wRespLen;
+    }while(FALSE);
+
+    if(TRUE == bComplete)
+    {
+        psRequest->pfHandler(psRequest->pvCtx, i4Status);
+    }
+}
+
+/**
+* Queues the calculation of a signature on a digest by the Security Chip.<br>
+*
+* Input:
+* - Same as #CmdLib_CalculateSign, the digest is copied to the request.
+* - Provide the request, owned by CmdLib until the handler is invoked.
+*
+* Output:
+* - The handler is invoked with pvCtx and the status, from the context completing the command.
+*   - The signature is returned in PpsSignature, which must stay valid until then.<br>
+*
+* Notes:
+* - The command is sent through #optiga_comms_submit, back-to-back with the other queued requests.
+* - The caller must prevent other commands while the queue is running, e.g. by holding the lock of the caller's layer.
+* - On a device error, the error code object is read by a request queued behind the ones already submitted.
+*   The error code ORed with #CMD_DEV_ERROR is then passed to the handler, #CMD_DEV_ERROR alone if the
+*   object was already read by an earlier failed request.
+* - If the request is not queued, an error is returned and the handler is not invoked.
+*
+* \param[in] PpsCalcSign Pointer to #sCalcSignOptions_d to provide input for signature generation
+* \param[in,out] PpsSignature Pointer to #sbBlob_d receiving the signature
+* \param[in,out] PpsRequest Pointer to #sCmdLibSignRequest_d holding the request
+* \param[in] pfHandler Handler invoked when the request completes
+* \param[in] pvCtx Context passed to the handler
+*
+* \retval  #CMD_LIB_OK
+* \retval  #CMD_LIB_NULL_PARAM
+* \retval  #CMD_LIB_INSUFFICIENT_MEMORY
+* \retval  #CMD_DEV_EXEC_ERROR
+*/
+int32_t CmdLib_SubmitCalculateSign(const sCalcSignOptions_d *PpsCalcSign, sbBlob_d *PpsSignature,
+                                   sCmdLibSignRequest_d *PpsRequest, pFnCmdLibHandler_d pfHandler, Void* pvCtx)
+{
+    int32_t i4Status = (int32_t)CMD_LIB_ERROR;
+    uint16_t wWritePosition = LEN_APDUHEADER;
+    uint16_t wPayloadLength;
+
+    do
+    {
+        //NULL checks
+        if((NULL == PpsCalcSign) || (NULL == PpsSignature) || (NULL == PpsSignature->prgbStream) ||
+           (NULL == PpsCalcSign->sDigestToSign.prgbStream) || (NULL == PpsRequest) || (NULL == pfHandler) ||
+           (NULL == p_optiga_comms))
+        {
+            i4Status = (int32_t)CMD_LIB_NULL_PARAM;
+            break;
+        }
+
+        //Digest TLV and key OID TLV
+        wPayloadLength = (uint16_t)(TAG_VALUE_OFFSET + PpsCalcSign->sDigestToSign.wLen + TAG_VALUE_OFFSET + LEN_OID_SIG_KEY);
+        if(sizeof(PpsRequest->rgbApdu) < (size_t)(LEN_APDUHEADER + wPayloadLength))
+        {
+            i4Status = (int32_t)CMD_LIB_INSUFFICIENT_MEMORY;
+            break;
+        }
+
+        PpsRequest->rgbApdu[OFFSET_CMD] = CMD_CALC_SIGN;
+        PpsRequest->rgbApdu[OFFSET_PARAM] = (uint8_t)PpsCalcSign->eSignScheme;
+        Utility_SetUint16(&PpsRequest->rgbApdu[OFFSET_LENGTH], wPayloadLength);
+
+        //Set digest tag, length, data
+        PpsRequest->rgbApdu[wWritePosition] = TAG_DIGEST;
+        Utility_SetUint16(&PpsRequest->rgbApdu[wWritePosition + TAG_LENGTH_OFFSET], PpsCalcSign->sDigestToSign.wLen);
+        OCP_MEMCPY(&PpsRequest->rgbApdu[wWritePosition + TAG_VALUE_OFFSET],PpsCalcSign->sDigestToSign.prgbStream,PpsCalcSign->sDigestToSign.wLen);
+        wWritePosition += TAG_VALUE_OFFSET + PpsCalcSign->sDigestToSign.wLen;
+
+        //Set OID of signature key tag, length, data
+        PpsRequest->rgbApdu[wWritePosition] = TAG_OID_SIG_KEY;
+        Utility_SetUint16(&PpsRequest->rgbApdu[wWritePosition + TAG_LENGTH_OFFSET], LEN_OID_SIG_KEY);
+        Utility_SetUint16(&PpsRequest->rgbApdu[wWritePosition + TAG_VALUE_OFFSET], PpsCalcSign->wOIDSignKey);
+
+        //The response overwrites the command in the same buffer
+        PpsRequest->sTxSegment.prgbStream = PpsRequest->rgbApdu;
+        PpsRequest->sTxSegment.wLen = (uint16_t)(LEN_APDUHEADER + wPayloadLength);
+        PpsRequest->sRxSegment.prgbStream = PpsRequest->rgbApdu;
+        PpsRequest->sRxSegment.wLen = sizeof(PpsRequest->rgbApdu);
+        PpsRequest->psSignature = PpsSignature;
+        PpsRequest->pfHandler = pfHandler;
+        PpsRequest->pvCtx = pvCtx;
+        PpsRequest->bReadError = FALSE;
+
+        PpsRequest->sCommsRequest.p_tx_segments = &PpsRequest->sTxSegment;
+        PpsRequest->sCommsRequest.tx_segment_count = 1;
+        PpsRequest->sCommsRequest.p_rx_segments = &PpsRequest->sRxSegment;
+        PpsRequest->sCommsRequest.rx_segment_count = 1;
+        PpsRequest->sCommsRequest.handler = CmdLib_SignRequestHandler;
+        PpsRequest->sCommsRequest.p_handler_ctx = PpsRequest;
+
+        if(OPTIGA_COMMS_SUCCESS != optiga_comms_submit(p_optiga_comms, &PpsRequest->sCommsRequest))
+        {
+            i4Status = (int32_t)CMD_DEV_EXEC_ERROR;
+            break;
+        }
+        i4Status = (int32_t)CMD_LIB_OK;
+    }while(FALSE);
+
+    return i4Status;
+}
+
 /**
 * Generates a shared secret by using the Security Chip.<br>
 *
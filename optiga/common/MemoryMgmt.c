@@ -0,0 +1,180 @@
+/**
+* MIT License
+*
+* Copyright (c) 2018 Infineon Technologies AG
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE
+*
+*
+*
+* \file
+*
+* \brief This file implements the allocation hooks and counters behind the OCP memory macros.
+*
+*
+* \ingroup  grMutualAuth
+*
+*/
+
+#include "optiga/common/MemoryMgmt.h"
+
+#ifdef OCP_USE_ALLOCATOR_HOOKS
+
+//Also brings the PAL_OS_HAS_xxx switches of pal_os_config.h
+#include "optiga/pal/pal_os_lock.h"
+
+#ifdef PAL_OS_HAS_CRITICAL_SECTION
+/// Protects the allocator and the counters against concurrent callers
+#define OCP_MEM_ENTER_CRITICAL()      pal_os_lock_enter_critical_section()
+#define OCP_MEM_EXIT_CRITICAL()       pal_os_lock_exit_critical_section()
+#else
+#define OCP_MEM_ENTER_CRITICAL()
+#define OCP_MEM_EXIT_CRITICAL()
+#endif
+
+/// @cond hidden
+//Configured allocator, NULL functions mean malloc/free
+static sOcpAllocator_d sOcpAllocator;
+
+//Allocation counters
+static sOcpAllocStats_d sOcpAllocStats;
+/// @endcond
+
+/**
+ * Routes the subsequent OCP_MALLOC, OCP_CALLOC and OCP_FREE calls to the given allocator.<br>
+ * Memory must be freed by the allocator which allocated it, hence the allocator is expected to be set before the first allocation.<br>
+ *
+ * \param[in] PpsAllocator Pointer to the allocator, NULL to restore malloc/free
+ */
+Void OCP_SetAllocator(const sOcpAllocator_d* PpsAllocator)
+{
+    OCP_MEM_ENTER_CRITICAL();
+    if(NULL == PpsAllocator)
+    {
+        OCP_MEMSET(&sOcpAllocator, 0, sizeof(sOcpAllocator));
+    }
+    else
+    {
+        sOcpAllocator = *PpsAllocator;
+    }
+    OCP_MEM_EXIT_CRITICAL();
+}
+
+/**
+ * Reads the allocation counters.<br>
+ *
+ * \param[out] PpsStats Pointer to the buffer receiving the counters
+ */
+Void OCP_GetAllocStats(sOcpAllocStats_d* PpsStats)
+{
+    if(NULL != PpsStats)
+    {
+        OCP_MEM_ENTER_CRITICAL();
+        *PpsStats = sOcpAllocStats;
+        OCP_MEM_EXIT_CRITICAL();
+    }
+}
+
+/**
+ * Allocates memory through the configured allocator and updates the counters.<br>
+ *
+ * \param[in] wSize Number of bytes
+ *
+ * \retval Pointer to the memory, NULL if not available
+ */
+Void* OCP_Malloc(size_t wSize)
+{
+    Void* pMemory;
+
+    OCP_MEM_ENTER_CRITICAL();
+    if(NULL != sOcpAllocator.pfMalloc)
+    {
+        pMemory = sOcpAllocator.pfMalloc(sOcpAllocator.pCtx, wSize);
+    }
+    else
+    {
+        pMemory = malloc(wSize);
+    }
+
+    if(NULL == pMemory)
+    {
+        sOcpAllocStats.dwFailCount++;
+    }
+    else
+    {
+        sOcpAllocStats.dwAllocCount++;
+        sOcpAllocStats.dwOutstanding++;
+    }
+    OCP_MEM_EXIT_CRITICAL();
+
+    return pMemory;
+}
+
+/**
+ * Allocates zero initialized memory through the configured allocator and updates the counters.<br>
+ *
+ * \param[in] wBlock     Number of blocks
+ * \param[in] wBlockSize Size of a block in bytes
+ *
+ * \retval Pointer to the memory, NULL if not available
+ */
+Void* OCP_Calloc(size_t wBlock, size_t wBlockSize)
+{
+    Void* pMemory = NULL;
+
+    //Check the total size for overflow
+    if((0 == wBlockSize) || (wBlock <= (((size_t)-1) / wBlockSize)))
+    {
+        pMemory = OCP_Malloc(wBlock * wBlockSize);
+    }
+    if(NULL != pMemory)
+    {
+        OCP_MEMSET(pMemory, 0, wBlock * wBlockSize);
+    }
+
+    return pMemory;
+}
+
+/**
+ * Frees the memory through the configured allocator and updates the counters.<br>
+ *
+ * \param[in] pMemory Pointer to the memory, NULL is ignored
+ */
+Void OCP_Free(Void* pMemory)
+{
+    if(NULL == pMemory)
+    {
+        return;
+    }
+
+    OCP_MEM_ENTER_CRITICAL();
+    if(NULL != sOcpAllocator.pfFree)
+    {
+        sOcpAllocator.pfFree(sOcpAllocator.pCtx, pMemory);
+    }
+    else
+    {
+        free(pMemory);
+    }
+    sOcpAllocStats.dwFreeCount++;
+    sOcpAllocStats.dwOutstanding--;
+    OCP_MEM_EXIT_CRITICAL();
+}
+
+#endif //OCP_USE_ALLOCATOR_HOOKS
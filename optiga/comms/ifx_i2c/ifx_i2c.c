@@ -77,6 +77,9 @@ static host_lib_status_t ifx_i2c_init(ifx_i2c_context_t* ifx_i2c_context);
 //lint --e{526} suppress "This API is defined in ifx_i2c_physical_layer. Since it is a low level API, 
 //to avoid exposing, header file is not included "
 extern host_lib_status_t ifx_i2c_pl_write_slave_address(ifx_i2c_context_t *p_ctx, uint8_t slave_address, uint8_t storage_type);
+//lint --e{526} suppress "This API is defined in ifx_i2c_physical_layer. Since it is a low level API, 
+//to avoid exposing, header file is not included "
+extern host_lib_status_t ifx_i2c_pl_get_poll_stats(ifx_i2c_context_t *p_ctx, uint8_t apdu_cmd, ifx_i2c_poll_stats_t* p_stats);
 /// @endcond
 /***********************************************************************************************************************
 * API PROTOTYPES
@@ -262,6 +265,57 @@ host_lib_status_t ifx_i2c_transceive(ifx_i2c_context_t *p_ctx,const uint8_t* p_d
     return api_status;
 }
 
+/**
+ * Sends a command gathered from a list of segments to I2C slave and scatters the response over a list of segments.<br>
+ *
+ *<b>Pre Conditions:</b>
+ * - IFX I2C protocol stack must be initialized.<br>
+ *
+ *<b>API Details:</b>
+ * - Transmit data(Command) to I2C slave, the command is the concatenation of the transmit segments.<br>
+ * - Receive data(Response) from I2C slave, the response is copied over the receive segments in order.<br>
+ * - The transport layer gathers each fragment directly from the segments, no contiguous copy of the command is made.<br>
+ *<br>
+ *
+ *<b>User Input:</b><br>
+ * - The input #ifx_i2c_context_t p_ctx must not be NULL.
+ * - The upper layer event handler and context are used as in #ifx_i2c_transceive.
+ *
+ *<b>Notes:</b>
+ * - The segment arrays and the memory referred by them must remain valid until the transceive completes.<br>
+ * - The first transmit segment must contain at least the command byte.<br>
+ * - If the total length of the receive segments is insufficient to copy the response bytes then
+ *   #IFX_I2C_STACK_MEM_ERROR error is returned.
+ *
+ * \param[in,out] p_ctx              Pointer to #ifx_i2c_context_t
+ * \param[in]     p_tx_segments      Pointer to the write data segments
+ * \param[in]     tx_segment_count   Number of write data segments
+ * \param[in]     p_rx_segments      Pointer to the receive data segments
+ * \param[in]     rx_segment_count   Number of receive data segments
+ * \param[out]    p_rx_length        Pointer to the number of bytes received
+ *
+ * \retval  #IFX_I2C_STACK_SUCCESS 
+ * \retval  #IFX_I2C_STACK_ERROR
+ */
+host_lib_status_t ifx_i2c_transceive_sg(ifx_i2c_context_t *p_ctx,const sbBlob_d* p_tx_segments, uint8_t tx_segment_count,
+                                        const sbBlob_d* p_rx_segments, uint8_t rx_segment_count, uint16_t* p_rx_length)
+{
+    host_lib_status_t api_status = (int32_t)IFX_I2C_STACK_ERROR;
+    // Proceed, if not busy and in idle state
+    if ((IFX_I2C_STATE_IDLE == p_ctx->state) && (IFX_I2C_STATUS_BUSY != p_ctx->status))
+    { 
+        p_ctx->p_upper_layer_rx_buffer = (NULL != p_rx_segments) ? p_rx_segments[0].prgbStream : NULL;
+        p_ctx->p_upper_layer_rx_buffer_len = p_rx_length;
+        api_status = ifx_i2c_tl_transceive_sg(p_ctx, p_tx_segments, tx_segment_count,
+                                              p_rx_segments, rx_segment_count, p_rx_length);
+        if (IFX_I2C_STACK_SUCCESS == api_status)
+        {
+            p_ctx->status = IFX_I2C_STATUS_BUSY;
+        }
+    }
+    return api_status;
+}
+
 
 /**
  * Closes the IFX I2C protocol stack for a given context.
@@ -351,15 +405,41 @@ host_lib_status_t ifx_i2c_set_slave_address(ifx_i2c_context_t *p_ctx, uint8_t sl
     return api_status;
 }
 
+/**
+* Reads the learned response time profile of an APDU command.<br>
+* 
+*<b>Pre Conditions:</b>
+* - None<br>
+*
+*<b>API Details:</b>
+*  - The physical layer measures the time from writing the last data frame of a command until the slave
+*    reports the response as ready, per APDU command byte.
+*  - The measurement has the resolution of #pal_os_timer_get_time_in_milliseconds.
+*  - Median and 99th percentile are reported as the upper bound of the histogram bucket holding them.
+*    Bucket n ends at #PL_ADAPTIVE_POLLING_MIN_US << n microseconds.
+*
+*<b>Notes:</b>
+* - Up to #PL_POLL_PROFILE_SIZE commands are profiled, the least sampled command is replaced by a new one.<br>
+* - Profiles are kept across ifx_i2c open/reset.<br>
+* - Returns #IFX_I2C_STACK_ERROR if #PL_ADAPTIVE_POLLING is disabled.
+*
+* \param[in]     p_ctx              Pointer to #ifx_i2c_context_t
+* \param[in]     apdu_cmd           APDU command byte.
+* \param[out]    p_stats            Pointer to #ifx_i2c_poll_stats_t
+* 
+* \retval  #IFX_I2C_STACK_SUCCESS
+* \retval  #IFX_I2C_STACK_ERROR   If no response time was recorded for the command.
+*/
+host_lib_status_t ifx_i2c_get_poll_stats(ifx_i2c_context_t *p_ctx, uint8_t apdu_cmd, ifx_i2c_poll_stats_t* p_stats)
+{
+    return ifx_i2c_pl_get_poll_stats(p_ctx, apdu_cmd, p_stats);
+}
+
 /// @cond hidden
 //lint --e{715} suppress "This is ignored as ifx_i2c_event_handler_t handler function prototype requires this argument"
 void ifx_i2c_tl_event_handler(ifx_i2c_context_t* p_ctx,host_lib_status_t event, const uint8_t* p_data, uint16_t data_len)
 {
-    // If there is no upper layer handler, don't do anything and return
-    if (NULL != p_ctx->upper_layer_event_handler)
-    {
-        p_ctx->upper_layer_event_handler(p_ctx->p_upper_layer_ctx,event);
-    }
+    // Update the state first, the upper layer may start the next transceive from its handler
     p_ctx->status = IFX_I2C_STATUS_NOT_BUSY;
     switch(p_ctx->state)
     {
@@ -372,6 +452,11 @@ void ifx_i2c_tl_event_handler(ifx_i2c_context_t* p_ctx,host_lib_status_t event,
         default:
             break;
     }
+    // If there is no upper layer handler, don't do anything and return
+    if (NULL != p_ctx->upper_layer_event_handler)
+    {
+        p_ctx->upper_layer_event_handler(p_ctx->p_upper_layer_ctx,event);
+    }
 }
 
 
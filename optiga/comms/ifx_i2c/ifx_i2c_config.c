@@ -69,6 +69,8 @@ ifx_i2c_context_t ifx_i2c_context_0 =
     &optiga_reset_0,
     /// optiga pal i2c context
     &optiga_pal_i2c_context_0,
+    /// Data link layer transmit window, stop-and-wait
+    1,
 };
 
 /***********************************************************************************************************************
@@ -66,6 +66,7 @@
 #define PL_ACTION_WRITE_REGISTER        (0x02)
 #define PL_I2C_CMD_WRITE                (0x01)
 #define PL_I2C_CMD_READ                 (0x02)
+#define PL_I2C_CMD_WRITE_READ           (0x03)
 
 // Physical Layer high level interface constants
 #define PL_ACTION_WRITE_FRAME           (0x01)
@@ -150,6 +151,14 @@ static void ifx_i2c_pl_guard_time_callback(void *p_ctx);
 static void ifx_i2c_pl_pal_event_handler(void *p_ctx, host_lib_status_t event);
 /// Physical layer low level event handler for set slave address
 static void ifx_i2c_pl_pal_slave_addr_event_handler(void *p_input_ctx, host_lib_status_t event);
+/// Physical Layer high level interface status polling interval
+static uint32_t ifx_i2c_pl_next_poll_interval(ifx_i2c_context_t *p_ctx);
+#if (PL_ADAPTIVE_POLLING == 1)
+/// Physical Layer adaptive polling, look up (or allocate) the profile of an APDU command
+static ifx_i2c_pl_poll_profile_t* ifx_i2c_pl_find_poll_profile(ifx_i2c_context_t *p_ctx, uint8_t apdu_cmd, uint8_t create);
+/// Physical Layer adaptive polling, record the execution time of the APDU command in progress
+static void ifx_i2c_pl_record_poll_sample(ifx_i2c_context_t *p_ctx);
+#endif
   
 /// @endcond
 /***********************************************************************************************************************
@@ -166,6 +175,9 @@ host_lib_status_t ifx_i2c_pl_init(ifx_i2c_context_t *p_ctx,ifx_i2c_event_handler
     p_ctx->p_pal_i2c_ctx->slave_address = p_ctx->slave_address;
     p_ctx->p_pal_i2c_ctx->upper_layer_event_handler = ifx_i2c_pl_pal_event_handler;
     p_ctx->pl.retry_counter = PL_POLLING_MAX_CNT;
+    // The learned poll profiles are kept across a reset
+    p_ctx->pl.p_poll_profile = NULL;
+    p_ctx->pl.poll_backoff_us = 0;
 	
 	if(TRUE == p_ctx->do_pal_init)
     {
@@ -293,10 +305,74 @@ host_lib_status_t ifx_i2c_pl_write_slave_address(ifx_i2c_context_t *p_ctx, uint8
     return status;
 }
 
+host_lib_status_t ifx_i2c_pl_get_poll_stats(ifx_i2c_context_t *p_ctx, uint8_t apdu_cmd, ifx_i2c_poll_stats_t* p_stats)
+{
+    host_lib_status_t status = IFX_I2C_STACK_ERROR;
+#if (PL_ADAPTIVE_POLLING == 1)
+    ifx_i2c_pl_poll_profile_t* p_profile;
+    uint32_t median_rank;
+    uint32_t p99_rank;
+    uint32_t count = 0;
+    uint8_t i;
+
+    do
+    {
+        p_profile = ifx_i2c_pl_find_poll_profile(p_ctx, apdu_cmd, FALSE);
+        if ((NULL == p_stats) || (NULL == p_profile) || (0 == p_profile->sample_count))
+        {
+            break;
+        }
+        p_stats->apdu_cmd         = apdu_cmd;
+        p_stats->sample_count     = p_profile->sample_count;
+        p_stats->expected_time_us = p_profile->expected_time_us;
+        p_stats->poll_count       = p_profile->poll_count;
+        p_stats->median_time_us   = 0;
+        p_stats->p99_time_us      = 0;
+
+        // Ranks of the percentiles, rounded up
+        median_rank = (p_profile->sample_count + 1) / 2;
+        p99_rank    = ((p_profile->sample_count * 99) + 99) / 100;
+        for (i = 0; i < PL_POLL_HISTOGRAM_SIZE; i++)
+        {
+            count += p_profile->histogram[i];
+            if ((0 == p_stats->median_time_us) && (count >= median_rank))
+            {
+                p_stats->median_time_us = (uint32_t)PL_ADAPTIVE_POLLING_MIN_US << i;
+            }
+            if (count >= p99_rank)
+            {
+                p_stats->p99_time_us = (uint32_t)PL_ADAPTIVE_POLLING_MIN_US << i;
+                break;
+            }
+        }
+        status = IFX_I2C_STACK_SUCCESS;
+    }while(FALSE);
+#else
+    // No statistics are collected with the fixed polling interval
+    (void)p_ctx;
+    (void)apdu_cmd;
+    (void)p_stats;
+#endif
+    return status;
+}
+
 static void ifx_i2c_pl_read_register(ifx_i2c_context_t *p_ctx,uint8_t reg_addr, uint16_t reg_len)
 {
     LOG_PL("[IFX-PL]: Read register %x len %d\n", reg_addr, reg_len);
 
+#if (PL_COMBINED_REGISTER_READ == 1)
+    // Write register address and read the content in one transaction, the guard time after the read still applies
+    p_ctx->pl.register_address = reg_addr;
+    p_ctx->pl.buffer_tx_len    = 1;
+    p_ctx->pl.buffer_rx_len    = reg_len;
+    p_ctx->pl.register_action  = PL_ACTION_READ_REGISTER;
+    p_ctx->pl.retry_counter    = PL_POLLING_MAX_CNT;
+    p_ctx->pl.i2c_cmd          = PL_I2C_CMD_WRITE_READ;
+
+    //lint --e{534} suppress "Return value is not required to be checked"
+    pal_i2c_write_read(p_ctx->p_pal_i2c_ctx, &p_ctx->pl.register_address, p_ctx->pl.buffer_tx_len,
+                       p_ctx->pl.buffer, p_ctx->pl.buffer_rx_len);
+#else
     // Prepare transmit buffer to write register address
     p_ctx->pl.buffer[0]     = reg_addr;
     p_ctx->pl.buffer_tx_len = 1;
@@ -309,6 +385,7 @@ static void ifx_i2c_pl_read_register(ifx_i2c_context_t *p_ctx,uint8_t reg_addr,
 
     //lint --e{534} suppress "Return value is not required to be checked"
     pal_i2c_write(p_ctx->p_pal_i2c_ctx,p_ctx->pl.buffer, p_ctx->pl.buffer_tx_len);
+#endif
 }
 
 
@@ -539,6 +616,8 @@ static void ifx_i2c_pl_frame_event_handler(ifx_i2c_context_t *p_ctx,host_lib_sta
     if (event != IFX_I2C_STACK_SUCCESS)
     {
         p_ctx->pl.frame_state = PL_STATE_READY;
+        // Do not learn from the failed exchange
+        p_ctx->pl.p_poll_profile = NULL;
         // I2C read or write failed, report to upper layer
         p_ctx->pl.upper_layer_event_handler(p_ctx,event, 0, 0);
     }
@@ -563,6 +642,7 @@ static void ifx_i2c_pl_frame_event_handler(ifx_i2c_context_t *p_ctx,host_lib_sta
             {
                 // Start polling status register
                 p_ctx->pl.frame_state			= PL_STATE_DATA_AVAILABLE;
+                p_ctx->pl.poll_backoff_us       = 0;
                 ifx_i2c_pl_read_register(p_ctx,PL_REG_I2C_STATE, PL_REG_LEN_I2C_STATE);
             }
             break;
@@ -576,6 +656,13 @@ static void ifx_i2c_pl_frame_event_handler(ifx_i2c_context_t *p_ctx,host_lib_sta
                     frame_size = (p_ctx->pl.buffer[2] << 8) | p_ctx->pl.buffer[3];
                     if ((frame_size > 0) && (frame_size <= p_ctx->frame_size))
                     {
+#if (PL_ADAPTIVE_POLLING == 1)
+                        // Control frames do not carry the response of the command
+                        if (frame_size > DL_HEADER_SIZE)
+                        {
+                            ifx_i2c_pl_record_poll_sample(p_ctx);
+                        }
+#endif
                         p_ctx->pl.frame_state = PL_STATE_RXTX;
                         ifx_i2c_pl_read_register(p_ctx,PL_REG_DATA, frame_size);
                     }
@@ -584,7 +671,7 @@ static void ifx_i2c_pl_frame_event_handler(ifx_i2c_context_t *p_ctx,host_lib_sta
                         // Continue polling STATUS register if retry limit is not reached
                         if ((pal_os_timer_get_time_in_milliseconds() - p_ctx->dl.frame_start_time) < p_ctx->dl.data_poll_timeout)
                         {
-                            pal_os_event_register_callback_oneshot(ifx_i2c_pl_status_poll_callback, (void *)p_ctx, PL_DATA_POLLING_INVERVAL_US);
+                            pal_os_event_register_callback_oneshot(ifx_i2c_pl_status_poll_callback, (void *)p_ctx, ifx_i2c_pl_next_poll_interval(p_ctx));
                         }
                         else
                         {
@@ -606,7 +693,7 @@ static void ifx_i2c_pl_frame_event_handler(ifx_i2c_context_t *p_ctx,host_lib_sta
                     // Continue polling STATUS register if retry limit is not reached
                     if ((pal_os_timer_get_time_in_milliseconds() - p_ctx->dl.frame_start_time) < p_ctx->dl.data_poll_timeout)
                     {
-                        pal_os_event_register_callback_oneshot(ifx_i2c_pl_status_poll_callback, (void *)p_ctx, PL_DATA_POLLING_INVERVAL_US);
+                        pal_os_event_register_callback_oneshot(ifx_i2c_pl_status_poll_callback, (void *)p_ctx, ifx_i2c_pl_next_poll_interval(p_ctx));
                     }
                     else
                     {
@@ -621,6 +708,14 @@ static void ifx_i2c_pl_frame_event_handler(ifx_i2c_context_t *p_ctx,host_lib_sta
             {
                 // Writing/reading of frame to/from DATA register complete
                 p_ctx->pl.frame_state = PL_STATE_READY;
+#if (PL_ADAPTIVE_POLLING == 1)
+                // A data frame was written, measure the time until its response is ready
+                if ((p_ctx->pl.frame_action == PL_ACTION_WRITE_FRAME) && (p_ctx->pl.tx_frame_len > DL_HEADER_SIZE))
+                {
+                    p_ctx->pl.p_poll_profile  = ifx_i2c_pl_find_poll_profile(p_ctx, p_ctx->tl.apdu_cmd, TRUE);
+                    p_ctx->pl.poll_start_time = pal_os_timer_get_time_in_milliseconds();
+                }
+#endif
                 p_ctx->pl.upper_layer_event_handler(p_ctx,IFX_I2C_STACK_SUCCESS, p_ctx->pl.buffer, p_ctx->pl.buffer_rx_len);
             }
             break;
@@ -645,6 +740,15 @@ static void ifx_i2c_pal_poll_callback(void *p_ctx)
         //lint --e{534} suppress "Return value is not required to be checked"
         pal_i2c_read(p_local_ctx->p_pal_i2c_ctx,p_local_ctx->pl.buffer, p_local_ctx->pl.buffer_rx_len);
     }
+#if (PL_COMBINED_REGISTER_READ == 1)
+    else if (p_local_ctx->pl.i2c_cmd == PL_I2C_CMD_WRITE_READ)
+    {
+        LOG_PL("[IFX-PL]: Poll Timer elapsed  -> Restart combined Read Register\n");
+        //lint --e{534} suppress "Return value is not required to be checked"
+        pal_i2c_write_read(p_local_ctx->p_pal_i2c_ctx, &p_local_ctx->pl.register_address, p_local_ctx->pl.buffer_tx_len,
+                           p_local_ctx->pl.buffer, p_local_ctx->pl.buffer_rx_len);
+    }
+#endif
 }
 
 
@@ -660,7 +764,7 @@ static void ifx_i2c_pl_guard_time_callback(void *p_ctx)
 			//lint --e{534} suppress "Return value is not required to be checked"
             pal_i2c_read(p_local_ctx->p_pal_i2c_ctx,p_local_ctx->pl.buffer, p_local_ctx->pl.buffer_rx_len);
     	}
-    	else if (p_local_ctx->pl.i2c_cmd == PL_I2C_CMD_READ)
+    	else if ((p_local_ctx->pl.i2c_cmd == PL_I2C_CMD_READ) || (p_local_ctx->pl.i2c_cmd == PL_I2C_CMD_WRITE_READ))
     	{
     		LOG_PL("[IFX-PL]: GT done -> REG is read\n");
     		ifx_i2c_pl_frame_event_handler(p_local_ctx,IFX_I2C_STACK_SUCCESS);
@@ -753,3 +857,117 @@ static void ifx_i2c_pl_pal_slave_addr_event_handler(void *p_ctx, host_lib_status
     pal_event_status = event;
 }
 
+static uint32_t ifx_i2c_pl_next_poll_interval(ifx_i2c_context_t *p_ctx)
+{
+#if (PL_ADAPTIVE_POLLING == 1)
+    ifx_i2c_pl_poll_profile_t* p_profile = p_ctx->pl.p_poll_profile;
+    uint32_t elapsed_us;
+    uint32_t interval_us;
+
+    if (0 == p_ctx->pl.poll_backoff_us)
+    {
+        // First miss, wait until the command is expected to complete
+        p_ctx->pl.poll_backoff_us = PL_ADAPTIVE_POLLING_MIN_US;
+        interval_us = PL_ADAPTIVE_POLLING_MIN_US;
+        if ((NULL != p_profile) && (0 != p_profile->sample_count))
+        {
+            elapsed_us = (pal_os_timer_get_time_in_milliseconds() - p_ctx->pl.poll_start_time) * 1000;
+            if (p_profile->expected_time_us > (elapsed_us + PL_ADAPTIVE_POLLING_MIN_US))
+            {
+                interval_us = p_profile->expected_time_us - elapsed_us;
+            }
+        }
+    }
+    else
+    {
+        // Response is late, back off exponentially
+        p_ctx->pl.poll_backoff_us <<= 1;
+        if (p_ctx->pl.poll_backoff_us > PL_DATA_POLLING_INVERVAL_US)
+        {
+            p_ctx->pl.poll_backoff_us = PL_DATA_POLLING_INVERVAL_US;
+        }
+        interval_us = p_ctx->pl.poll_backoff_us;
+    }
+
+    if (NULL != p_profile)
+    {
+        p_profile->poll_count++;
+    }
+    LOG_PL("[IFX-PL]: Next status poll in %d us\n", interval_us);
+    return interval_us;
+#else
+    (void)p_ctx;
+    return PL_DATA_POLLING_INVERVAL_US;
+#endif
+}
+
+#if (PL_ADAPTIVE_POLLING == 1)
+static ifx_i2c_pl_poll_profile_t* ifx_i2c_pl_find_poll_profile(ifx_i2c_context_t *p_ctx, uint8_t apdu_cmd, uint8_t create)
+{
+    ifx_i2c_pl_poll_profile_t* p_profile = NULL;
+    ifx_i2c_pl_poll_profile_t* p_replace = &p_ctx->pl.poll_profile[0];
+    uint8_t i;
+
+    for (i = 0; i < PL_POLL_PROFILE_SIZE; i++)
+    {
+        // An entry is in use once it has samples or polls
+        if (((0 != p_ctx->pl.poll_profile[i].sample_count) || (0 != p_ctx->pl.poll_profile[i].poll_count))
+            && (apdu_cmd == p_ctx->pl.poll_profile[i].apdu_cmd))
+        {
+            p_profile = &p_ctx->pl.poll_profile[i];
+            break;
+        }
+        // Unused entries are taken first, otherwise the least sampled command is replaced
+        if (p_ctx->pl.poll_profile[i].sample_count < p_replace->sample_count)
+        {
+            p_replace = &p_ctx->pl.poll_profile[i];
+        }
+    }
+
+    if ((NULL == p_profile) && (TRUE == create))
+    {
+        memset(p_replace, 0, sizeof(ifx_i2c_pl_poll_profile_t));
+        p_replace->apdu_cmd = apdu_cmd;
+        p_profile = p_replace;
+    }
+    return p_profile;
+}
+
+static void ifx_i2c_pl_record_poll_sample(ifx_i2c_context_t *p_ctx)
+{
+    ifx_i2c_pl_poll_profile_t* p_profile = p_ctx->pl.p_poll_profile;
+    uint32_t sample_us;
+    uint8_t bucket = 0;
+
+    if (NULL != p_profile)
+    {
+        p_ctx->pl.p_poll_profile = NULL;
+
+        // The timer has millisecond resolution, faster responses count as the shortest poll interval
+        sample_us = (pal_os_timer_get_time_in_milliseconds() - p_ctx->pl.poll_start_time) * 1000;
+        if (sample_us < PL_ADAPTIVE_POLLING_MIN_US)
+        {
+            sample_us = PL_ADAPTIVE_POLLING_MIN_US;
+        }
+
+        // Moving average with a weight of 1/8 for the new sample
+        if (0 == p_profile->sample_count)
+        {
+            p_profile->expected_time_us = sample_us;
+        }
+        else
+        {
+            p_profile->expected_time_us = (p_profile->expected_time_us - (p_profile->expected_time_us >> 3)) + (sample_us >> 3);
+        }
+
+        while ((bucket < (PL_POLL_HISTOGRAM_SIZE - 1)) && (sample_us > ((uint32_t)PL_ADAPTIVE_POLLING_MIN_US << bucket)))
+        {
+            bucket++;
+        }
+        p_profile->histogram[bucket]++;
+        p_profile->sample_count++;
+        LOG_PL("[IFX-PL]: Command %x completed in %d us\n", p_profile->apdu_cmd, sample_us);
+    }
+}
+#endif
+
@@ -99,6 +99,8 @@ _STATIC_H host_lib_status_t ifx_i2c_tl_send_chaining_error(ifx_i2c_context_t *p_
 _STATIC_H uint8_t ifx_i2c_tl_calculate_pctr(const ifx_i2c_context_t *p_ctx);
 /// Checks if chaining error occured based on current and previous pctr
 _STATIC_H host_lib_status_t ifx_i2c_tl_check_chaining_error(uint8_t current_chaning, uint8_t previous_chaining);
+/// Copies received fragment payload to the receive segments
+_STATIC_H void ifx_i2c_tl_scatter_fragment(ifx_i2c_context_t *p_ctx, const uint8_t* p_data, uint16_t data_len);
 /// @endcond
 /***********************************************************************************************************************
 * API PROTOTYPES
@@ -126,17 +128,67 @@ host_lib_status_t ifx_i2c_tl_init(ifx_i2c_context_t *p_ctx,ifx_i2c_event_handler
 
 host_lib_status_t ifx_i2c_tl_transceive(ifx_i2c_context_t *p_ctx,uint8_t* p_packet, uint16_t packet_len,
                                uint8_t* p_recv_packet, uint16_t* recv_packet_len)
+{
+    // Transport Layer must be idle, the segments below are in use until the transceive completes
+    if ((p_ctx->tl.state != TL_STATE_IDLE) || (recv_packet_len == NULL))
+    {
+        return IFX_I2C_STACK_ERROR;
+    }
+    p_ctx->tl.tx_segment.prgbStream = p_packet;
+    p_ctx->tl.tx_segment.wLen = packet_len;
+    p_ctx->tl.rx_segment.prgbStream = p_recv_packet;
+    p_ctx->tl.rx_segment.wLen = *recv_packet_len;
+    return ifx_i2c_tl_transceive_sg(p_ctx, &p_ctx->tl.tx_segment, 1, &p_ctx->tl.rx_segment, 1, recv_packet_len);
+}
+
+host_lib_status_t ifx_i2c_tl_transceive_sg(ifx_i2c_context_t *p_ctx,const sbBlob_d* p_tx_segments, uint8_t tx_segment_count,
+                                           const sbBlob_d* p_rx_segments, uint8_t rx_segment_count,
+                                           uint16_t* recv_packet_len)
 {
     host_lib_status_t status = IFX_I2C_STACK_ERROR;
-    LOG_TL("[IFX-TL]: Transceive txlen %d\n", packet_len);
+    uint32_t packet_len = 0;
+    uint32_t recv_capacity = 0;
+    uint8_t index;
 
     do
     {
         // Check function arguments
-        if (p_packet == NULL || packet_len == 0 )
+        if ((p_tx_segments == NULL) || (tx_segment_count == 0) ||
+            (p_rx_segments == NULL) || (rx_segment_count == 0) || (recv_packet_len == NULL))
         {
             break;
-        }   
+        }
+        for (index = 0; index < tx_segment_count; index++)
+        {
+            if ((p_tx_segments[index].prgbStream == NULL) && (p_tx_segments[index].wLen != 0))
+            {
+                break;
+            }
+            packet_len += p_tx_segments[index].wLen;
+        }
+        // The first segment must hold the command byte, the packet length must fit the protocol
+        if ((index != tx_segment_count) || (packet_len == 0) || (packet_len > 0xFFFF) ||
+            (p_tx_segments[0].wLen == 0))
+        {
+            break;
+        }
+        for (index = 0; index < rx_segment_count; index++)
+        {
+            if ((p_rx_segments[index].prgbStream == NULL) && (p_rx_segments[index].wLen != 0))
+            {
+                break;
+            }
+            recv_capacity += p_rx_segments[index].wLen;
+        }
+        if (index != rx_segment_count)
+        {
+            break;
+        }
+        if (recv_capacity > 0xFFFF)
+        {
+            recv_capacity = 0xFFFF;
+        }
+        LOG_TL("[IFX-TL]: Transceive txlen %d\n", packet_len);
         // Transport Layer must be idle
         if (p_ctx->tl.state != TL_STATE_IDLE)
         {
@@ -144,10 +196,14 @@ host_lib_status_t ifx_i2c_tl_transceive(ifx_i2c_context_t *p_ctx,uint8_t* p_pack
         }    
         p_ctx->tl.state = TL_STATE_TX;
         p_ctx->tl.api_start_time = pal_os_timer_get_time_in_milliseconds();    
-        p_ctx->tl.p_actual_packet = p_packet;
-        p_ctx->tl.actual_packet_length = packet_len;
+        p_ctx->tl.p_tx_segments = p_tx_segments;
+        p_ctx->tl.tx_segment_count = tx_segment_count;
+        p_ctx->tl.actual_packet_length = (uint16_t)packet_len;
+        p_ctx->tl.apdu_cmd = p_tx_segments[0].prgbStream[0];
         p_ctx->tl.packet_offset = 0; 
-        p_ctx->tl.p_recv_packet_buffer = p_recv_packet;
+        p_ctx->tl.p_rx_segments = p_rx_segments;
+        p_ctx->tl.rx_segment_count = rx_segment_count;
+        p_ctx->tl.recv_packet_capacity = (uint16_t)recv_capacity;
         p_ctx->tl.p_recv_packet_buffer_length = recv_packet_len;
         p_ctx->tl.total_recv_length = 0;
         p_ctx->tl.chaining_error_count = 0;
@@ -205,6 +261,11 @@ _STATIC_H uint8_t ifx_i2c_tl_calculate_pctr(const ifx_i2c_context_t *p_ctx)
 _STATIC_H host_lib_status_t ifx_i2c_tl_send_next_fragment(ifx_i2c_context_t *p_ctx)
 {
     uint8_t pctr = 0;
+    const sbBlob_d* p_segment = p_ctx->tl.p_tx_segments;
+    uint16_t segment_offset = p_ctx->tl.packet_offset;
+    uint8_t* p_frame_data = p_ctx->tx_frame_buffer + IFX_I2C_TL_HEADER_OFFSET + TL_HEADER_SIZE;
+    uint16_t remaining;
+    uint16_t chunk;
     // Calculate size of fragment (last one might be shorter)
     uint16_t tl_fragment_size = p_ctx->tl.max_packet_length;
     pctr = ifx_i2c_tl_calculate_pctr(p_ctx);
@@ -213,13 +274,62 @@ _STATIC_H host_lib_status_t ifx_i2c_tl_send_next_fragment(ifx_i2c_context_t *p_c
         tl_fragment_size = p_ctx->tl.actual_packet_length - p_ctx->tl.packet_offset;
     }
 
+    // Locate the segment holding the start of the fragment
+    while (segment_offset >= p_segment->wLen)
+    {
+        segment_offset -= p_segment->wLen;
+        p_segment++;
+    }
+    // Gather all but the last piece of the fragment into the frame
+    remaining = tl_fragment_size;
+    chunk = p_segment->wLen - segment_offset;
+    while (chunk < remaining)
+    {
+        memcpy(p_frame_data, p_segment->prgbStream + segment_offset, chunk);
+        p_frame_data += chunk;
+        remaining -= chunk;
+        segment_offset = 0;
+        p_segment++;
+        chunk = p_segment->wLen;
+    }
+
     // Assign the pctr 
     p_ctx->tx_frame_buffer[IFX_I2C_TL_HEADER_OFFSET] = pctr;
-    //copy the data
-    memcpy(p_ctx->tx_frame_buffer+IFX_I2C_TL_HEADER_OFFSET+1,p_ctx->tl.p_actual_packet + p_ctx->tl.packet_offset,tl_fragment_size);
     p_ctx->tl.packet_offset += tl_fragment_size;
-    //send the fragment to dl layer
-    return ifx_i2c_dl_send_frame(p_ctx,tl_fragment_size+1);
+    // Data link layer may leave the fragment unacknowledged if more are to follow
+    p_ctx->dl.tx_more_frames = (p_ctx->tl.packet_offset < p_ctx->tl.actual_packet_length);
+    //send the fragment to dl layer, the last piece is copied while the frame CRC is calculated
+    return ifx_i2c_dl_send_frame_copy(p_ctx,tl_fragment_size+1,
+                                      p_segment->prgbStream + segment_offset, remaining);
+}
+
+_STATIC_H void ifx_i2c_tl_scatter_fragment(ifx_i2c_context_t *p_ctx, const uint8_t* p_data, uint16_t data_len)
+{
+    const sbBlob_d* p_segment = p_ctx->tl.p_rx_segments;
+    uint16_t segment_offset = p_ctx->tl.total_recv_length;
+    uint16_t chunk;
+
+    p_ctx->tl.total_recv_length += data_len;
+    while (data_len)
+    {
+        // Skip the segments which are already filled
+        if (segment_offset >= p_segment->wLen)
+        {
+            segment_offset -= p_segment->wLen;
+            p_segment++;
+            continue;
+        }
+        chunk = p_segment->wLen - segment_offset;
+        if (chunk > data_len)
+        {
+            chunk = data_len;
+        }
+        memcpy(p_segment->prgbStream + segment_offset, p_data, chunk);
+        p_data += chunk;
+        data_len -= chunk;
+        segment_offset = 0;
+        p_segment++;
+    }
 }
 
 _STATIC_H host_lib_status_t ifx_i2c_tl_send_chaining_error(ifx_i2c_context_t *p_ctx)
@@ -374,14 +484,21 @@ _STATIC_H void ifx_i2c_dl_event_handler(ifx_i2c_context_t* p_ctx,host_lib_status
                     {
                         LOG_TL("[IFX-TL]: Rx : No chain/Last chain received, Inform UL\n");
 
+                        // Check for possible receive buffer overflow
+                        if ((p_ctx->tl.total_recv_length + data_len - 1) > p_ctx->tl.recv_packet_capacity)
+                        {
+                            LOG_TL("[IFX-TL]: Rx : Buffer overflow\n");
+                            p_ctx->tl.error_event = IFX_I2C_STACK_MEM_ERROR;
+                            p_ctx->tl.state = TL_STATE_ERROR;
+                            break;
+                        }
                         exit_machine = FALSE;
-                        // Copy frame payload to transport layer receive buffer
-                        memcpy(p_ctx->tl.p_recv_packet_buffer + p_ctx->tl.total_recv_length, p_data + 1, data_len - 1);
-                        p_ctx->tl.total_recv_length += (data_len - 1);
+                        // Copy frame payload to transport layer receive segments
+                        ifx_i2c_tl_scatter_fragment(p_ctx, p_data + 1, data_len - 1);
                         // Inform upper layer that a packet has arrived
                         p_ctx->tl.state = TL_STATE_IDLE;
                         *p_ctx->tl.p_recv_packet_buffer_length = p_ctx->tl.total_recv_length;
-                        p_ctx->tl.upper_layer_event_handler(p_ctx,IFX_I2C_STACK_SUCCESS, p_ctx->tl.p_recv_packet_buffer, *p_ctx->tl.p_recv_packet_buffer_length);
+                        p_ctx->tl.upper_layer_event_handler(p_ctx,IFX_I2C_STACK_SUCCESS, p_ctx->tl.p_rx_segments[0].prgbStream, *p_ctx->tl.p_recv_packet_buffer_length);
                     }
                     else
                     {
@@ -409,7 +526,7 @@ _STATIC_H void ifx_i2c_dl_event_handler(ifx_i2c_context_t* p_ctx,host_lib_status
                     break;
                 }
                 // Check for possible receive buffer overflow
-                if ((p_ctx->tl.total_recv_length + data_len - 1) > (*p_ctx->tl.p_recv_packet_buffer_length))
+                if ((p_ctx->tl.total_recv_length + data_len - 1) > p_ctx->tl.recv_packet_capacity)
                 {
                     LOG_TL("[IFX-TL]: Chain : Buffer overflow\n");
 					p_ctx->tl.error_event = IFX_I2C_STACK_MEM_ERROR;
@@ -421,9 +538,8 @@ _STATIC_H void ifx_i2c_dl_event_handler(ifx_i2c_context_t* p_ctx,host_lib_status
                     p_ctx->tl.state = TL_STATE_ERROR;
                     break;
                 }                
-                // Copy frame payload to transport layer receive buffer
-                memcpy(p_ctx->tl.p_recv_packet_buffer + p_ctx->tl.total_recv_length, p_data + 1, data_len - 1);
-                p_ctx->tl.total_recv_length += (data_len - 1);
+                // Copy frame payload to transport layer receive segments
+                ifx_i2c_tl_scatter_fragment(p_ctx, p_data + 1, data_len - 1);
 
                 p_ctx->tl.previous_chaining = pctr;
                 LOG_TL("[IFX-TL]: Chain : Continue  in receive mode\n");
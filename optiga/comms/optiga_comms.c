@@ -35,6 +35,8 @@
  *********************************************************************************************************************/
 #include "optiga/comms/optiga_comms.h"
 #include "optiga/ifx_i2c/ifx_i2c.h"
+#include "optiga/pal/pal_os_lock.h"
+#include "optiga/pal/pal_os_timer.h"
 /// @cond hidden
 /**********************************************************************************************************************
  * MACROS
@@ -43,6 +45,18 @@
  #define OPTIGA_COMMS_INUSE     (0x01)
  /// Optiga comms is free
  #define OPTIGA_COMMS_FREE      (0x00)
+ /// Optiga comms is running the request queue
+ #define OPTIGA_COMMS_QUEUED    (0x02)
+
+//PAL_OS_HAS_CRITICAL_SECTION comes from pal_os_config.h, shared with the PAL
+#ifdef PAL_OS_HAS_CRITICAL_SECTION
+ /// Protects the request queue and the comms state against concurrent submission
+ #define OPTIGA_COMMS_ENTER_CRITICAL()      pal_os_lock_enter_critical_section()
+ #define OPTIGA_COMMS_EXIT_CRITICAL()       pal_os_lock_exit_critical_section()
+#else
+ #define OPTIGA_COMMS_ENTER_CRITICAL()
+ #define OPTIGA_COMMS_EXIT_CRITICAL()
+#endif
 /**********************************************************************************************************************
  * LOCAL DATA
  *********************************************************************************************************************/
@@ -51,6 +65,8 @@
  *********************************************************************************************************************/
 static host_lib_status_t check_optiga_comms_state(optiga_comms_t *p_ctx);
 static void ifx_i2c_event_handler(void* upper_layer_ctx, host_lib_status_t event);
+static void optiga_comms_queue_run(optiga_comms_t *p_ctx, optiga_comms_request_t* p_completed, host_lib_status_t event);
+static optiga_comms_request_t* optiga_comms_queue_pop(optiga_comms_t *p_ctx, host_lib_status_t event);
 
 /// @endcond
 /**********************************************************************************************************************
@@ -201,6 +217,165 @@ host_lib_status_t optiga_comms_transceive(optiga_comms_t *p_ctx,const uint8_t* p
     return status;
 }
 
+/**
+ * Sends a command gathered from segments to OPTIGA and scatters the response over segments.<br>
+ *
+ *
+ *<b>Pre Conditions:</b>
+ * - Communication channel must be established with OPTIGA.<br>
+ *
+ *<b>API Details:</b>
+ * - Transmit data(Command) to OPTIGA. The command is the concatenation of the transmit segments.<br>
+ * - Receive data(Response) from OPTIGA. The response is copied over the receive segments in order.<br>
+ * - The command is sent from the segments directly, the caller does not have to assemble it in one buffer.<br>
+ *<br>
+ *
+ *<b>User Input:</b><br>
+ * - The input #optiga_comms_t p_ctx must not be NULL.<br>
+ * - The parameters in #optiga_comms_t must be initialized as for #optiga_comms_transceive().<br>
+ *
+ *<b>Notes:</b>
+ * - The segment arrays and the memory referred by them must remain valid until the transceive completes.<br>
+ * - The first transmit segment must contain at least the command byte.<br>
+ * - If the total length of the receive segments is insufficient to copy the response bytes then
+ *   #IFX_I2C_STACK_MEM_ERROR error is returned.
+ *
+ *
+ * \param[in,out] p_ctx              Pointer to #optiga_comms_t
+ * \param[in]     p_tx_segments      Pointer to the write data segments
+ * \param[in]     tx_segment_count   Number of write data segments
+ * \param[in]     p_rx_segments      Pointer to the receive data segments
+ * \param[in]     rx_segment_count   Number of receive data segments
+ * \param[out]    p_rx_length        Pointer to the number of bytes received
+ *
+ * \retval  #OPTIGA_COMMS_SUCCESS
+ * \retval  #OPTIGA_COMMS_ERROR
+ * \retval  #IFX_I2C_STACK_MEM_ERROR
+ */
+host_lib_status_t optiga_comms_transceive_sg(optiga_comms_t *p_ctx,
+                                             const sbBlob_d* p_tx_segments, uint8_t tx_segment_count,
+                                             const sbBlob_d* p_rx_segments, uint8_t rx_segment_count,
+                                             uint16_t* p_rx_length)
+{
+    host_lib_status_t status = OPTIGA_COMMS_ERROR;
+    if (OPTIGA_COMMS_SUCCESS == check_optiga_comms_state(p_ctx))
+    {
+        ((ifx_i2c_context_t*)(p_ctx->comms_ctx))->p_upper_layer_ctx = (void*)p_ctx;
+        ((ifx_i2c_context_t*)(p_ctx->comms_ctx))->upper_layer_event_handler = ifx_i2c_event_handler;
+        status = ifx_i2c_transceive_sg((ifx_i2c_context_t*)(p_ctx->comms_ctx),p_tx_segments,tx_segment_count,
+                                       p_rx_segments,rx_segment_count,p_rx_length);
+        if (IFX_I2C_STACK_SUCCESS != status)
+        {
+            p_ctx->state = OPTIGA_COMMS_FREE;
+        }
+    }
+    return status;
+}
+
+/**
+ * Queues a request to be sent to OPTIGA.<br>
+ *
+ *
+ *<b>Pre Conditions:</b>
+ * - Communication channel must be established with OPTIGA.<br>
+ *
+ *<b>API Details:</b>
+ * - Appends the request to the queue and returns. The queue is started if the channel is free,
+ *   else it is started when the operation in progress completes.<br>
+ * - The queued requests are sent back-to-back in submission order. The next request is started
+ *   from the completion of the previous one, before its handler is invoked.<br>
+ * - The handler of the request is invoked with p_handler_ctx and the completion status.<br>
+ *<br>
+ *
+ *<b>User Input:</b><br>
+ * - The input #optiga_comms_t p_ctx must not be NULL.<br>
+ * - The <b>comms_ctx</b> must be initialized with a valid #ifx_i2c_context<br>
+ * - The segments of p_request must be set as for #optiga_comms_transceive_sg().<br>
+ *
+ *<b>Notes:</b>
+ * - The request, its segments and buffers are owned by the comms layer until the handler is invoked.<br>
+ * - The handler is invoked from the context completing the request, usually the pal_os_event callback.
+ *   If the request cannot be started it is completed with the error status, possibly from this call.<br>
+ * - #optiga_comms_open, #optiga_comms_reset, #optiga_comms_transceive and #optiga_comms_close
+ *   return #OPTIGA_COMMS_ERROR while the queue is running.<br>
+ *
+ * \param[in,out] p_ctx             Pointer to #optiga_comms_t
+ * \param[in,out] p_request         Pointer to the request
+ *
+ * \retval  #OPTIGA_COMMS_SUCCESS
+ * \retval  #OPTIGA_COMMS_ERROR
+ */
+host_lib_status_t optiga_comms_submit(optiga_comms_t *p_ctx, optiga_comms_request_t* p_request)
+{
+    uint8_t start_queue = FALSE;
+
+    if ((NULL == p_ctx) || (NULL == p_request) || (NULL == p_request->p_tx_segments) || 
+        (0 == p_request->tx_segment_count))
+    {
+        return OPTIGA_COMMS_ERROR;
+    }
+    p_request->rx_length = 0;
+    p_request->p_next = NULL;
+    p_request->submit_time = pal_os_timer_get_time_in_milliseconds();
+
+    OPTIGA_COMMS_ENTER_CRITICAL();
+    if (NULL == p_ctx->p_queue_tail)
+    {
+        p_ctx->p_queue_head = p_request;
+    }
+    else
+    {
+        p_ctx->p_queue_tail->p_next = p_request;
+    }
+    p_ctx->p_queue_tail = p_request;
+    p_ctx->queue_stats.submitted_count++;
+    if (++p_ctx->queue_stats.depth > p_ctx->queue_stats.max_depth)
+    {
+        p_ctx->queue_stats.max_depth = p_ctx->queue_stats.depth;
+    }
+    // Take the channel if free, else the queue is started by the operation in progress
+    if (OPTIGA_COMMS_FREE == p_ctx->state)
+    {
+        p_ctx->state = OPTIGA_COMMS_QUEUED;
+        start_queue = TRUE;
+    }
+    OPTIGA_COMMS_EXIT_CRITICAL();
+
+    if (start_queue)
+    {
+        optiga_comms_queue_run(p_ctx, NULL, OPTIGA_COMMS_SUCCESS);
+    }
+    return OPTIGA_COMMS_SUCCESS;
+}
+
+/**
+ * Reads the counters of the request queue.<br>
+ *
+ *<b>Pre Conditions:</b>
+ * - None<br>
+ *
+ *<b>API Details:</b>
+ * - Copies a consistent snapshot of the queue depth, wait time and latency counters.<br>
+ *<br>
+ *
+ * \param[in]     p_ctx             Pointer to #optiga_comms_t
+ * \param[out]    p_stats           Pointer to the buffer receiving the counters
+ *
+ * \retval  #OPTIGA_COMMS_SUCCESS
+ * \retval  #OPTIGA_COMMS_ERROR
+ */
+host_lib_status_t optiga_comms_get_queue_stats(optiga_comms_t *p_ctx, optiga_comms_queue_stats_t* p_stats)
+{
+    if ((NULL == p_ctx) || (NULL == p_stats))
+    {
+        return OPTIGA_COMMS_ERROR;
+    }
+    OPTIGA_COMMS_ENTER_CRITICAL();
+    *p_stats = p_ctx->queue_stats;
+    OPTIGA_COMMS_EXIT_CRITICAL();
+    return OPTIGA_COMMS_SUCCESS;
+}
+
 /**
  * Closes the communication with OPTIGA.<br>
  *
@@ -241,20 +416,123 @@ host_lib_status_t optiga_comms_close(optiga_comms_t *p_ctx)
 static host_lib_status_t check_optiga_comms_state(optiga_comms_t *p_ctx)
 {
     host_lib_status_t status = OPTIGA_COMMS_ERROR;
-    if ((NULL != p_ctx) && (p_ctx->state != OPTIGA_COMMS_INUSE))
+    if (NULL != p_ctx)
     {
-        p_ctx->state = OPTIGA_COMMS_INUSE;
-        status = OPTIGA_COMMS_SUCCESS;
+        OPTIGA_COMMS_ENTER_CRITICAL();
+        if (p_ctx->state == OPTIGA_COMMS_FREE)
+        {
+            p_ctx->state = OPTIGA_COMMS_INUSE;
+            status = OPTIGA_COMMS_SUCCESS;
+        }
+        OPTIGA_COMMS_EXIT_CRITICAL();
     }
     return status;
 }
 
+// Starts the request at the head of the queue, the channel must be owned by the caller.
+// Requests which cannot be started are completed with the error, the channel is freed once the queue is empty.
+// The handler of the previously completed request (if any) is invoked after the next one is started,
+// handlers are always invoked in submission order.
+static void optiga_comms_queue_run(optiga_comms_t *p_ctx, optiga_comms_request_t* p_completed, host_lib_status_t event)
+{
+    optiga_comms_request_t* p_request;
+    host_lib_status_t status;
+
+    for (;;)
+    {
+        OPTIGA_COMMS_ENTER_CRITICAL();
+        p_request = p_ctx->p_queue_head;
+        p_ctx->state = (NULL == p_request) ? OPTIGA_COMMS_FREE : OPTIGA_COMMS_QUEUED;
+        OPTIGA_COMMS_EXIT_CRITICAL();
+        if (NULL == p_request)
+        {
+            break;
+        }
+
+        p_request->start_time = pal_os_timer_get_time_in_milliseconds();
+        ((ifx_i2c_context_t*)(p_ctx->comms_ctx))->p_upper_layer_ctx = (void*)p_ctx;
+        ((ifx_i2c_context_t*)(p_ctx->comms_ctx))->upper_layer_event_handler = ifx_i2c_event_handler;
+        status = ifx_i2c_transceive_sg((ifx_i2c_context_t*)(p_ctx->comms_ctx),
+                                       p_request->p_tx_segments, p_request->tx_segment_count,
+                                       p_request->p_rx_segments, p_request->rx_segment_count,
+                                       &p_request->rx_length);
+        if (IFX_I2C_STACK_SUCCESS == status)
+        {
+            break;
+        }
+        p_request = optiga_comms_queue_pop(p_ctx, OPTIGA_COMMS_ERROR);
+        if ((NULL != p_completed) && (NULL != p_completed->handler))
+        {
+            p_completed->handler(p_completed->p_handler_ctx, event);
+        }
+        p_completed = p_request;
+        event = OPTIGA_COMMS_ERROR;
+    }
+    if ((NULL != p_completed) && (NULL != p_completed->handler))
+    {
+        p_completed->handler(p_completed->p_handler_ctx, event);
+    }
+}
+
+// Removes the completed request from the head of the queue and updates the counters
+static optiga_comms_request_t* optiga_comms_queue_pop(optiga_comms_t *p_ctx, host_lib_status_t event)
+{
+    optiga_comms_request_t* p_request;
+    uint32_t wait_time;
+    uint32_t latency;
+
+    OPTIGA_COMMS_ENTER_CRITICAL();
+    p_request = p_ctx->p_queue_head;
+    p_ctx->p_queue_head = p_request->p_next;
+    if (NULL == p_ctx->p_queue_head)
+    {
+        p_ctx->p_queue_tail = NULL;
+    }
+    p_request->p_next = NULL;
+    p_request->complete_time = pal_os_timer_get_time_in_milliseconds();
+    wait_time = p_request->start_time - p_request->submit_time;
+    latency = p_request->complete_time - p_request->submit_time;
+
+    p_ctx->queue_stats.depth--;
+    p_ctx->queue_stats.completed_count++;
+    if (IFX_I2C_STACK_SUCCESS != event)
+    {
+        p_ctx->queue_stats.error_count++;
+    }
+    p_ctx->queue_stats.total_wait_time += wait_time;
+    if (wait_time > p_ctx->queue_stats.max_wait_time)
+    {
+        p_ctx->queue_stats.max_wait_time = wait_time;
+    }
+    p_ctx->queue_stats.total_latency += latency;
+    if (latency > p_ctx->queue_stats.max_latency)
+    {
+        p_ctx->queue_stats.max_latency = latency;
+    }
+    OPTIGA_COMMS_EXIT_CRITICAL();
+
+    return p_request;
+}
+
 //lint --e{818} suppress "This is ignored as upper layer handler function prototype requires this argument"
 static void ifx_i2c_event_handler(void* upper_layer_ctx, host_lib_status_t event)
 {
-    void* ctx = ((optiga_comms_t*)upper_layer_ctx)->upper_layer_ctx;
-    ((optiga_comms_t*)upper_layer_ctx)->upper_layer_handler(ctx,event);
-    ((optiga_comms_t*)upper_layer_ctx)->state = OPTIGA_COMMS_FREE;
+    optiga_comms_t* p_ctx = (optiga_comms_t*)upper_layer_ctx;
+    optiga_comms_request_t* p_request;
+
+    if (OPTIGA_COMMS_QUEUED == p_ctx->state)
+    {
+        p_request = optiga_comms_queue_pop(p_ctx, event);
+        // Keep the bus busy with the next request before handing the response back
+        optiga_comms_queue_run(p_ctx, p_request, event);
+    }
+    else
+    {
+        // Release the channel (or pass it to the requests queued meanwhile) before informing the caller,
+        // so that the caller can issue the next operation from the handler.
+        optiga_comms_queue_run(p_ctx, NULL, OPTIGA_COMMS_SUCCESS);
+        p_ctx->upper_layer_handler(p_ctx->upper_layer_ctx,event);
+    }
 }
 
 /// @endcond
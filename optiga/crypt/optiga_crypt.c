@@ -31,6 +31,330 @@
 
 #include "optiga/optiga_crypt.h"
 #include "optiga/pal/pal_os_lock.h"
+#include "optiga/pal/pal_os_timer.h"
+
+#ifdef OPTIGA_CRYPT_RANDOM_POOL_SIZE
+/// @cond hidden
+#ifndef OPTIGA_CRYPT_RANDOM_POOL_LOW_WATER
+#define OPTIGA_CRYPT_RANDOM_POOL_LOW_WATER      (OPTIGA_CRYPT_RANDOM_POOL_SIZE / 2)
+#endif
+
+//Number of random bytes read from OPTIGA with one command, in the range of 8 - 256 bytes
+#ifndef OPTIGA_CRYPT_RANDOM_POOL_BATCH
+#define OPTIGA_CRYPT_RANDOM_POOL_BATCH          (0x100)
+#endif
+
+#if (OPTIGA_CRYPT_RANDOM_POOL_BATCH < 0x08) || (OPTIGA_CRYPT_RANDOM_POOL_BATCH > 0x100)
+#error "OPTIGA_CRYPT_RANDOM_POOL_BATCH must be in the range of 8 - 256"
+#endif
+#if (OPTIGA_CRYPT_RANDOM_POOL_SIZE < OPTIGA_CRYPT_RANDOM_POOL_BATCH) || (OPTIGA_CRYPT_RANDOM_POOL_SIZE > 0x8000)
+#error "OPTIGA_CRYPT_RANDOM_POOL_SIZE must be in the range of OPTIGA_CRYPT_RANDOM_POOL_BATCH - 32768"
+#endif
+
+#ifndef OPTIGA_CRYPT_RANDOM_POOL_RNG_TYPE
+#define OPTIGA_CRYPT_RANDOM_POOL_RNG_TYPE       OPTIGA_RNG_TYPE_TRNG
+#endif
+
+//Health tests of NIST SP 800-90B 4.4 on bytes, for an assumed min-entropy of 4 bits per byte and a false positive rate of 2^-20
+#define RANDOM_HEALTH_REPETITION_CUTOFF         (6)
+#define RANDOM_HEALTH_PROPORTION_WINDOW         (512)
+#define RANDOM_HEALTH_PROPORTION_CUTOFF         (62)
+
+//The pool is taken from by the requesting threads while the background task fills it
+#ifndef PAL_OS_HAS_CRITICAL_SECTION
+#error "OPTIGA_CRYPT_RANDOM_POOL_SIZE requires PAL_OS_HAS_CRITICAL_SECTION, see pal_os_config.h"
+#endif
+#define RANDOM_POOL_ENTER_CRITICAL()            pal_os_lock_enter_critical_section()
+#define RANDOM_POOL_EXIT_CRITICAL()             pal_os_lock_exit_critical_section()
+
+typedef struct optiga_crypt_random_health
+{
+    //Last byte and number of its consecutive occurrences
+    uint8_t repetition_value;
+    uint16_t repetition_count;
+    //First byte of the window, number of its occurrences and number of bytes in the window
+    uint8_t proportion_value;
+    uint16_t proportion_count;
+    uint16_t proportion_samples;
+} optiga_crypt_random_health_t;
+
+//Ring buffer of random bytes, read from random_pool_read_index
+static uint8_t random_pool[OPTIGA_CRYPT_RANDOM_POOL_SIZE];
+static uint16_t random_pool_read_index;
+static uint16_t random_pool_level;
+static bool_t random_pool_refill_requested;
+static optiga_crypt_random_pool_refill_request_t random_pool_refill_request;
+static void * random_pool_refill_request_ctx;
+static optiga_crypt_random_health_t random_health;
+static optiga_crypt_random_stats_t random_stats;
+
+//Runs the health tests on the bytes read from OPTIGA, returns FALSE if a test fails
+static bool_t optiga_crypt_random_health_check(const uint8_t * p_data, uint16_t length)
+{
+    bool_t passed = TRUE;
+    uint16_t index;
+
+    for (index = 0; index < length; index++)
+    {
+        //Repetition count test
+        if ((0 != random_health.repetition_count) && (p_data[index] == random_health.repetition_value))
+        {
+            if (++random_health.repetition_count >= RANDOM_HEALTH_REPETITION_CUTOFF)
+            {
+                passed = FALSE;
+            }
+        }
+        else
+        {
+            random_health.repetition_value = p_data[index];
+            random_health.repetition_count = 1;
+        }
+
+        //Adaptive proportion test
+        if (0 == random_health.proportion_samples)
+        {
+            random_health.proportion_value = p_data[index];
+            random_health.proportion_count = 1;
+        }
+        else if (p_data[index] == random_health.proportion_value)
+        {
+            if (++random_health.proportion_count >= RANDOM_HEALTH_PROPORTION_CUTOFF)
+            {
+                passed = FALSE;
+            }
+        }
+        if (++random_health.proportion_samples >= RANDOM_HEALTH_PROPORTION_WINDOW)
+        {
+            random_health.proportion_samples = 0;
+        }
+    }
+
+    if (FALSE == passed)
+    {
+        //The tests restart with the next bytes read
+        memset(&random_health, 0, sizeof(random_health));
+    }
+    return passed;
+}
+
+//Reads random bytes from OPTIGA, the bytes which fail the health tests are discarded
+static optiga_lib_status_t optiga_crypt_random_fetch(uint8_t * random_data, uint16_t random_data_length)
+{
+    optiga_lib_status_t return_value;
+    sRngOptions_d rand_options;
+    sCmdResponse_d rand_response;
+
+    rand_options.eRngType       = (eRngType_d)OPTIGA_CRYPT_RANDOM_POOL_RNG_TYPE;
+    rand_options.wRandomDataLen = random_data_length;
+
+    rand_response.prgbBuffer    = random_data;
+    rand_response.wBufferLength = random_data_length;
+    rand_response.wRespLength   = 0;
+
+    while (pal_os_lock_acquire() != PAL_STATUS_SUCCESS);
+    return_value = CmdLib_GetRandom(&rand_options,&rand_response);
+    if ((CMD_LIB_OK == return_value) && (FALSE == optiga_crypt_random_health_check(random_data, random_data_length)))
+    {
+        memset(random_data, 0, random_data_length);
+        RANDOM_POOL_ENTER_CRITICAL();
+        random_stats.health_failure_count++;
+        RANDOM_POOL_EXIT_CRITICAL();
+        return_value = OPTIGA_LIB_ERROR;
+    }
+    pal_os_lock_release();
+
+    if (CMD_LIB_OK == return_value)
+    {
+        RANDOM_POOL_ENTER_CRITICAL();
+        random_stats.refill_count++;
+        random_stats.refill_bytes += random_data_length;
+        RANDOM_POOL_EXIT_CRITICAL();
+    }
+
+    if (CMD_LIB_OK != return_value)
+    {
+        return OPTIGA_LIB_ERROR;
+    }
+    return OPTIGA_LIB_SUCCESS;
+}
+
+//Appends random bytes to the pool, the bytes which do not fit are dropped
+static void optiga_crypt_random_pool_put(uint8_t * random_data, uint16_t random_data_length)
+{
+    uint16_t write_index;
+    uint16_t length;
+
+    RANDOM_POOL_ENTER_CRITICAL();
+    if (random_data_length > (OPTIGA_CRYPT_RANDOM_POOL_SIZE - random_pool_level))
+    {
+        random_data_length = OPTIGA_CRYPT_RANDOM_POOL_SIZE - random_pool_level;
+    }
+    write_index = (uint16_t)((random_pool_read_index + random_pool_level) % OPTIGA_CRYPT_RANDOM_POOL_SIZE);
+    length = OPTIGA_CRYPT_RANDOM_POOL_SIZE - write_index;
+    if (length > random_data_length)
+    {
+        length = random_data_length;
+    }
+    memcpy(&random_pool[write_index], random_data, length);
+    memcpy(random_pool, random_data + length, random_data_length - length);
+    random_pool_level += random_data_length;
+    if (random_pool_level >= OPTIGA_CRYPT_RANDOM_POOL_LOW_WATER)
+    {
+        random_pool_refill_requested = FALSE;
+    }
+    RANDOM_POOL_EXIT_CRITICAL();
+}
+
+//Takes up to random_data_length bytes from the pool, returns the number of bytes taken
+static uint16_t optiga_crypt_random_pool_take(uint8_t * random_data, uint16_t random_data_length, bool_t * p_request_refill)
+{
+    uint16_t length;
+
+    RANDOM_POOL_ENTER_CRITICAL();
+    if (random_data_length > random_pool_level)
+    {
+        random_data_length = random_pool_level;
+    }
+    length = OPTIGA_CRYPT_RANDOM_POOL_SIZE - random_pool_read_index;
+    if (length > random_data_length)
+    {
+        length = random_data_length;
+    }
+    memcpy(random_data, &random_pool[random_pool_read_index], length);
+    memcpy(random_data + length, random_pool, random_data_length - length);
+    //The bytes taken are never provided again
+    memset(&random_pool[random_pool_read_index], 0, length);
+    memset(random_pool, 0, random_data_length - length);
+    random_pool_read_index = (uint16_t)((random_pool_read_index + random_data_length) % OPTIGA_CRYPT_RANDOM_POOL_SIZE);
+    random_pool_level -= random_data_length;
+    *p_request_refill = FALSE;
+    if ((random_pool_level < OPTIGA_CRYPT_RANDOM_POOL_LOW_WATER) && (FALSE == random_pool_refill_requested) &&
+        (NULL != random_pool_refill_request))
+    {
+        random_pool_refill_requested = TRUE;
+        *p_request_refill = TRUE;
+    }
+    RANDOM_POOL_EXIT_CRITICAL();
+
+    return random_data_length;
+}
+
+//Provides random bytes from the pool, the bytes missing in the pool are read from OPTIGA
+static optiga_lib_status_t optiga_crypt_random_from_pool(uint8_t * random_data, uint16_t random_data_length)
+{
+    optiga_lib_status_t return_value = OPTIGA_LIB_SUCCESS;
+    uint8_t batch[OPTIGA_CRYPT_RANDOM_POOL_BATCH];
+    uint32_t start_time = pal_os_timer_get_time_in_milliseconds();
+    uint32_t latency;
+    uint16_t length = 0;
+    bool_t request_refill = FALSE;
+
+    //Requests larger than the pool are read from OPTIGA directly to keep the pool for the small ones
+    if (random_data_length <= OPTIGA_CRYPT_RANDOM_POOL_SIZE)
+    {
+        length = optiga_crypt_random_pool_take(random_data, random_data_length, &request_refill);
+    }
+    if (length < random_data_length)
+    {
+        RANDOM_POOL_ENTER_CRITICAL();
+        random_stats.pool_miss_count++;
+        RANDOM_POOL_EXIT_CRITICAL();
+    }
+
+    while (length < random_data_length)
+    {
+        if ((random_data_length - length) >= OPTIGA_CRYPT_RANDOM_POOL_BATCH)
+        {
+            return_value = optiga_crypt_random_fetch(random_data + length, OPTIGA_CRYPT_RANDOM_POOL_BATCH);
+            length += OPTIGA_CRYPT_RANDOM_POOL_BATCH;
+        }
+        else
+        {
+            //The rest of the batch is kept in the pool
+            return_value = optiga_crypt_random_fetch(batch, OPTIGA_CRYPT_RANDOM_POOL_BATCH);
+            if (OPTIGA_LIB_SUCCESS == return_value)
+            {
+                memcpy(random_data + length, batch, random_data_length - length);
+                optiga_crypt_random_pool_put(batch + (random_data_length - length),
+                                             OPTIGA_CRYPT_RANDOM_POOL_BATCH - (random_data_length - length));
+                memset(batch, 0, sizeof(batch));
+            }
+            length = random_data_length;
+        }
+        if (OPTIGA_LIB_SUCCESS != return_value)
+        {
+            memset(random_data, 0, random_data_length);
+            break;
+        }
+    }
+
+    if (request_refill)
+    {
+        random_pool_refill_request(random_pool_refill_request_ctx);
+    }
+
+    latency = pal_os_timer_get_time_in_milliseconds() - start_time;
+    RANDOM_POOL_ENTER_CRITICAL();
+    random_stats.request_count++;
+    random_stats.total_latency += latency;
+    if (latency > random_stats.max_latency)
+    {
+        random_stats.max_latency = latency;
+    }
+    RANDOM_POOL_EXIT_CRITICAL();
+
+    return return_value;
+}
+/// @endcond
+
+void optiga_crypt_random_pool_set_refill_request(optiga_crypt_random_pool_refill_request_t handler, void * p_ctx)
+{
+    RANDOM_POOL_ENTER_CRITICAL();
+    random_pool_refill_request_ctx = p_ctx;
+    random_pool_refill_request = handler;
+    random_pool_refill_requested = FALSE;
+    RANDOM_POOL_EXIT_CRITICAL();
+}
+
+optiga_lib_status_t optiga_crypt_random_pool_refill(void)
+{
+    optiga_lib_status_t return_value = OPTIGA_LIB_SUCCESS;
+    uint8_t batch[OPTIGA_CRYPT_RANDOM_POOL_BATCH];
+    uint16_t level;
+
+    while (1)
+    {
+        RANDOM_POOL_ENTER_CRITICAL();
+        level = random_pool_level;
+        RANDOM_POOL_EXIT_CRITICAL();
+        if ((level + OPTIGA_CRYPT_RANDOM_POOL_BATCH) > OPTIGA_CRYPT_RANDOM_POOL_SIZE)
+        {
+            break;
+        }
+        return_value = optiga_crypt_random_fetch(batch, OPTIGA_CRYPT_RANDOM_POOL_BATCH);
+        if (OPTIGA_LIB_SUCCESS != return_value)
+        {
+            //The next consumer below the low-water mark requests the refill again
+            RANDOM_POOL_ENTER_CRITICAL();
+            random_pool_refill_requested = FALSE;
+            RANDOM_POOL_EXIT_CRITICAL();
+            break;
+        }
+        optiga_crypt_random_pool_put(batch, OPTIGA_CRYPT_RANDOM_POOL_BATCH);
+    }
+    memset(batch, 0, sizeof(batch));
+
+    return return_value;
+}
+
+void optiga_crypt_random_get_stats(optiga_crypt_random_stats_t * p_stats)
+{
+    RANDOM_POOL_ENTER_CRITICAL();
+    *p_stats = random_stats;
+    p_stats->pool_level = random_pool_level;
+    RANDOM_POOL_EXIT_CRITICAL();
+}
+#endif
 
 optiga_lib_status_t optiga_crypt_random(optiga_rng_types_t rng_type,
                                         uint8_t * random_data,
@@ -48,7 +372,14 @@ optiga_lib_status_t optiga_crypt_random(optiga_rng_types_t rng_type,
     rand_response.wBufferLength = random_data_length;
     rand_response.wRespLength   = 0;
 
-    while (pal_os_lock_acquire() != OPTIGA_LIB_SUCCESS);
+#ifdef OPTIGA_CRYPT_RANDOM_POOL_SIZE
+    if (OPTIGA_CRYPT_RANDOM_POOL_RNG_TYPE == rng_type)
+    {
+        return optiga_crypt_random_from_pool(random_data, random_data_length);
+    }
+#endif
+
+    while (pal_os_lock_acquire() != PAL_STATUS_SUCCESS);
     return_value = CmdLib_GetRandom(&rand_options,&rand_response);
     pal_os_lock_release();
 
@@ -59,11 +390,298 @@ optiga_lib_status_t optiga_crypt_random(optiga_rng_types_t rng_type,
     return OPTIGA_LIB_SUCCESS;
 }
 
-optiga_lib_status_t optiga_crypt_hash_start(optiga_hash_context_t * hash_ctx)
+#ifdef OPTIGA_CRYPT_DRBG
+/// @cond hidden
+//Reads the entropy for seeding the DRBG from the OPTIGA TRNG
+static int optiga_crypt_drbg_entropy(void * p_ctx, unsigned char * p_entropy, size_t length)
+{
+    optiga_crypt_drbg_t * drbg = (optiga_crypt_drbg_t *)p_ctx;
+
+    if ((length > 0xFFFF) ||
+        (OPTIGA_LIB_SUCCESS != optiga_crypt_random(OPTIGA_RNG_TYPE_TRNG, p_entropy, (uint16_t)length)))
+    {
+        return MBEDTLS_ERR_CTR_DRBG_ENTROPY_SOURCE_FAILED;
+    }
+    drbg->reseed_count++;
+    drbg->reseed_time = pal_os_timer_get_time_in_milliseconds();
+    drbg->generated_since_reseed = 0;
+    return 0;
+}
+/// @endcond
+
+optiga_lib_status_t optiga_crypt_drbg_init(optiga_crypt_drbg_t * drbg,
+                                           const uint8_t * personalization,
+                                           uint16_t personalization_length)
+{
+    drbg->reseed_bytes = OPTIGA_CRYPT_DRBG_RESEED_BYTES;
+    drbg->reseed_interval = OPTIGA_CRYPT_DRBG_RESEED_INTERVAL_MS;
+    drbg->generated_since_reseed = 0;
+    drbg->reseed_time = 0;
+    drbg->reseed_count = 0;
+
+    mbedtls_ctr_drbg_init(&drbg->ctr_drbg);
+    if (0 != mbedtls_ctr_drbg_seed(&drbg->ctr_drbg, optiga_crypt_drbg_entropy, drbg,
+                                   personalization, personalization_length))
+    {
+        mbedtls_ctr_drbg_free(&drbg->ctr_drbg);
+        return OPTIGA_LIB_ERROR;
+    }
+    return OPTIGA_LIB_SUCCESS;
+}
+
+void optiga_crypt_drbg_set_reseed_budget(optiga_crypt_drbg_t * drbg,
+                                         uint32_t reseed_bytes,
+                                         uint32_t reseed_interval)
+{
+    drbg->reseed_bytes = reseed_bytes;
+    drbg->reseed_interval = reseed_interval;
+}
+
+optiga_lib_status_t optiga_crypt_drbg_generate(optiga_crypt_drbg_t * drbg,
+                                               uint8_t * random_data,
+                                               uint32_t random_data_length)
+{
+    uint32_t length;
+
+    while (random_data_length > 0)
+    {
+        //Reseed from OPTIGA once the byte or time budget is used up
+        if ((drbg->generated_since_reseed >= drbg->reseed_bytes) ||
+            ((0 != drbg->reseed_interval) &&
+             ((pal_os_timer_get_time_in_milliseconds() - drbg->reseed_time) >= drbg->reseed_interval)))
+        {
+            if (0 != mbedtls_ctr_drbg_reseed(&drbg->ctr_drbg, NULL, 0))
+            {
+                return OPTIGA_LIB_ERROR;
+            }
+        }
+
+        length = (random_data_length > MBEDTLS_CTR_DRBG_MAX_REQUEST) ? MBEDTLS_CTR_DRBG_MAX_REQUEST : random_data_length;
+        if ((drbg->generated_since_reseed < drbg->reseed_bytes) &&
+            ((drbg->reseed_bytes - drbg->generated_since_reseed) < length))
+        {
+            length = drbg->reseed_bytes - drbg->generated_since_reseed;
+        }
+        //The instance is used by one thread only, so the DRBG state is not locked
+        if (0 != mbedtls_ctr_drbg_random_with_add(&drbg->ctr_drbg, random_data, length, NULL, 0))
+        {
+            return OPTIGA_LIB_ERROR;
+        }
+        drbg->generated_since_reseed += length;
+        random_data += length;
+        random_data_length -= length;
+    }
+    return OPTIGA_LIB_SUCCESS;
+}
+
+void optiga_crypt_drbg_free(optiga_crypt_drbg_t * drbg)
+{
+    mbedtls_ctr_drbg_free(&drbg->ctr_drbg);
+}
+#endif
+
+/// @cond hidden
+//Size of the imported context and of the export request in a hash command
+#define HASH_IMPORT_OVERHEAD        (CALC_HASH_IMPORT_OR_EXPORT_OVERHEAD_SIZE + CALC_HASH_SHA256_CONTEXT_SIZE)
+#define HASH_EXPORT_OVERHEAD        (CALC_HASH_IMPORT_OR_EXPORT_OVERHEAD_SIZE)
+
+#ifdef OPTIGA_CRYPT_HASH_RESIDENT_CONTEXT
+//Size of the response header and of the tag and length of a response item
+#define HASH_RESPONSE_HEADER_SIZE   (4)
+#define HASH_RESPONSE_TAG_SIZE      (3)
+//Size of the OID, offset and length of the data in OPTIGA
+#define HASH_OID_DATA_SIZE          (6)
+
+static optiga_crypt_hash_stats_t hash_stats;
+#endif
+
+static eContextAction_d optiga_crypt_hash_context_action(bool_t import_context, bool_t export_context)
+{
+    if (import_context)
+    {
+        return export_context ? eImportExport : eImport;
+    }
+    return export_context ? eExport : eUnused;
+}
+
+//Sends a hash command
+static optiga_lib_status_t optiga_crypt_calc_hash(sCalcHash_d * hash_options)
 {
     optiga_lib_status_t return_value;
+
+    return_value = CmdLib_CalcHash(hash_options);
+
+#ifdef OPTIGA_CRYPT_HASH_RESIDENT_CONTEXT
+    hash_stats.bytes_sent += CALC_HASH_FIXED_OVERHEAD_SIZE +
+                             ((eDataStream == hash_options->eHashDataType) ? hash_options->sDataStream.wLen : HASH_OID_DATA_SIZE);
+    hash_stats.bytes_received += HASH_RESPONSE_HEADER_SIZE;
+    if ((eImport == hash_options->sContextInfo.eContextAction) ||
+        (eImportExport == hash_options->sContextInfo.eContextAction))
+    {
+        hash_stats.context_import_count++;
+        hash_stats.bytes_sent += CALC_HASH_IMPORT_OR_EXPORT_OVERHEAD_SIZE + hash_options->sContextInfo.dwContextLen;
+    }
+    if ((eExport == hash_options->sContextInfo.eContextAction) ||
+        (eImportExport == hash_options->sContextInfo.eContextAction))
+    {
+        hash_stats.context_export_count++;
+        hash_stats.bytes_sent += CALC_HASH_IMPORT_OR_EXPORT_OVERHEAD_SIZE;
+        hash_stats.bytes_received += HASH_RESPONSE_TAG_SIZE + CALC_HASH_SHA256_CONTEXT_SIZE;
+    }
+    if (eFinalizeHash == hash_options->eHashSequence)
+    {
+        hash_stats.bytes_received += HASH_RESPONSE_TAG_SIZE + hash_options->sOutHash.wBufferLength;
+    }
+#endif
+
+    return return_value;
+}
+
+#ifdef OPTIGA_CRYPT_HASH_RESIDENT_CONTEXT
+//Number of contexts which are not finalized nor released, their state is kept by the library
+#ifndef OPTIGA_CRYPT_HASH_CONTEXT_SLOTS
+#define OPTIGA_CRYPT_HASH_CONTEXT_SLOTS     (2)
+#endif
+
+typedef struct optiga_crypt_hash_slot
+{
+    //Context the slot belongs to, only compared and never dereferenced, NULL if the slot is free
+    const optiga_hash_context_t * p_owner;
+    uint8_t hash_algo;
+    //TRUE if context holds the state exported from OPTIGA, FALSE while it is active in OPTIGA
+    bool_t parked;
+    uint8_t context[CALC_HASH_SHA256_CONTEXT_SIZE];
+} optiga_crypt_hash_slot_t;
+
+//The state of a context is never written to memory of the caller, except by the API invoked with the context
+static optiga_crypt_hash_slot_t hash_slots[OPTIGA_CRYPT_HASH_CONTEXT_SLOTS];
+
+static optiga_crypt_hash_slot_t * optiga_crypt_hash_find_slot(const optiga_hash_context_t * hash_ctx)
+{
+    uint8_t index;
+
+    for (index = 0; index < OPTIGA_CRYPT_HASH_CONTEXT_SLOTS; index++)
+    {
+        if (hash_ctx == hash_slots[index].p_owner)
+        {
+            return &hash_slots[index];
+        }
+    }
+    return NULL;
+}
+
+//Exports the context kept active in OPTIGA to its slot, a context which cannot be exported is lost
+static optiga_lib_status_t optiga_crypt_hash_evict(void)
+{
+    optiga_lib_status_t return_value = CMD_LIB_OK;
+    const optiga_hash_context_t * owner = (const optiga_hash_context_t *)CmdLib_GetHashContextOwner();
+    optiga_crypt_hash_slot_t * slot;
+    uint8_t datastream[1];
+    sCalcHash_d hash_options;
+
+    if (NULL != owner)
+    {
+        slot = optiga_crypt_hash_find_slot(owner);
+
+        hash_options.eHashAlg      = (eHashAlg_d)(slot->hash_algo);
+        hash_options.eHashDataType = eDataStream;
+        hash_options.eHashSequence = eContinueHash;
+        hash_options.sDataStream.prgbStream = datastream;
+        hash_options.sDataStream.wLen       = 0x00;    //No data
+
+        hash_options.sContextInfo.pbContextData  = slot->context;
+        hash_options.sContextInfo.dwContextLen   = sizeof(slot->context);
+        hash_options.sContextInfo.eContextAction = eExport;
+
+        return_value = optiga_crypt_calc_hash(&hash_options);
+        slot->parked = (CMD_LIB_OK == return_value) ? TRUE : FALSE;
+        CmdLib_SetHashContextOwner(NULL);
+    }
+    return return_value;
+}
+
+/*
+ * Makes OPTIGA available for the hash context and gives the context to import, NULL if the context is
+ * active in OPTIGA or is started. The context gets a slot until it is finalized or released.
+ */
+static optiga_lib_status_t optiga_crypt_hash_acquire(optiga_hash_context_t * hash_ctx, bool_t start,
+                                                     sContextInfo_d * p_import)
+{
+    optiga_crypt_hash_slot_t * slot = optiga_crypt_hash_find_slot(hash_ctx);
+    bool_t active = (hash_ctx == (optiga_hash_context_t *)CmdLib_GetHashContextOwner()) ? TRUE : FALSE;
+
+    p_import->pbContextData = NULL;
+    if (NULL == slot)
+    {
+        //Started or released before, the state is in the buffer of the caller
+        slot = optiga_crypt_hash_find_slot(NULL);
+        if (NULL == slot)
+        {
+            return OPTIGA_CRYPT_ERROR_MEMORY_INSUFFICIENT;
+        }
+        p_import->pbContextData = hash_ctx->context_buffer;
+        p_import->dwContextLen  = hash_ctx->context_buffer_length;
+    }
+    else if ((FALSE == active) && (FALSE == start))
+    {
+        if (FALSE == slot->parked)
+        {
+            //Lost by a failed export or by reopening the application
+            slot->p_owner = NULL;
+            return OPTIGA_LIB_ERROR;
+        }
+        p_import->pbContextData = slot->context;
+        p_import->dwContextLen  = sizeof(slot->context);
+    }
+
+    if (FALSE == active)
+    {
+        (void)optiga_crypt_hash_evict();
+    }
+    slot->p_owner   = hash_ctx;
+    slot->hash_algo = hash_ctx->hash_algo;
+    slot->parked    = FALSE;
+    if (TRUE == start)
+    {
+        p_import->pbContextData = NULL;
+    }
+    return OPTIGA_LIB_SUCCESS;
+}
+
+/*
+ * Records the hash context as the one kept active in OPTIGA, or frees its slot if the hash commands
+ * failed or the context is finalized. The context of another owner is left as it is.
+ */
+static void optiga_crypt_hash_resident(optiga_hash_context_t * hash_ctx, bool_t succeeded)
+{
+    optiga_crypt_hash_slot_t * slot = optiga_crypt_hash_find_slot(hash_ctx);
+
+    if (succeeded)
+    {
+        CmdLib_SetHashContextOwner(hash_ctx);
+    }
+    else
+    {
+        if (hash_ctx == (optiga_hash_context_t *)CmdLib_GetHashContextOwner())
+        {
+            CmdLib_SetHashContextOwner(NULL);
+        }
+        if (NULL != slot)
+        {
+            memset(slot->context, 0, sizeof(slot->context));
+            slot->p_owner = NULL;
+        }
+    }
+}
+#endif
+/// @endcond
+
+optiga_lib_status_t optiga_crypt_hash_start(optiga_hash_context_t * hash_ctx)
+{
+    optiga_lib_status_t return_value = OPTIGA_LIB_SUCCESS;
     uint8_t rgbDataStream[1];
     sCalcHash_d hash_options;
+    bool_t export_context = TRUE;
 
     hash_options.eHashAlg      = (eHashAlg_d)(hash_ctx->hash_algo);
     hash_options.eHashDataType = eDataStream;
@@ -74,17 +692,25 @@ optiga_lib_status_t optiga_crypt_hash_start(optiga_hash_context_t * hash_ctx)
 
     hash_options.sContextInfo.pbContextData  = hash_ctx->context_buffer;
     hash_options.sContextInfo.dwContextLen   = hash_ctx->context_buffer_length;
-    hash_options.sContextInfo.eContextAction = eExport;
-
-    while (pal_os_lock_acquire() != OPTIGA_LIB_SUCCESS);
-    return_value = CmdLib_CalcHash(&hash_options);
-    pal_os_lock_release();
 
-    if (CMD_LIB_OK != return_value)
+    while (pal_os_lock_acquire() != PAL_STATUS_SUCCESS);
+#ifdef OPTIGA_CRYPT_HASH_RESIDENT_CONTEXT
+    //The started context is kept active in OPTIGA
+    return_value = optiga_crypt_hash_acquire(hash_ctx, TRUE, &hash_options.sContextInfo);
+    export_context = FALSE;
+#endif
+    if (OPTIGA_LIB_SUCCESS == return_value)
     {
-        return OPTIGA_LIB_ERROR;
+        hash_options.sContextInfo.eContextAction = optiga_crypt_hash_context_action(FALSE, export_context);
+        return_value = optiga_crypt_calc_hash(&hash_options);
+#ifdef OPTIGA_CRYPT_HASH_RESIDENT_CONTEXT
+        optiga_crypt_hash_resident(hash_ctx, (CMD_LIB_OK == return_value));
+#endif
+        return_value = (CMD_LIB_OK == return_value) ? OPTIGA_LIB_SUCCESS : OPTIGA_LIB_ERROR;
     }
-    return OPTIGA_LIB_SUCCESS;
+    pal_os_lock_release();
+
+    return return_value;
 }
 
 optiga_lib_status_t optiga_crypt_hash_update(optiga_hash_context_t * hash_ctx,
@@ -93,29 +719,19 @@ optiga_lib_status_t optiga_crypt_hash_update(optiga_hash_context_t * hash_ctx,
 {
     optiga_lib_status_t return_value;
     sCalcHash_d hash_options;
-    //To read the maximum communication buffer size.
-    uint16_t max_comms_buffer;
-    //To hold the remaining communication buffer size to hold the data
-    uint16_t remaining_comm_buffer_size = 0;
 
     //Hash the data
     //Available_Size = (wMaxCommsBuffer - #CALC_HASH_FIXED_OVERHEAD_SIZE)
     uint16_t remaining_comm_bfr_sz_basic;
 
-    //Import context to security chip, calculate hash and export hash
-    //Available_Size = (wMaxCommsBuffer - #CALC_HASH_FIXED_OVERHEAD_SIZE - #CALC_HASH_IMPORT_AND_EXPORT_OVERHEAD_SIZE - #CALC_HASH_SHA256_CONTEXT_SIZE)
-    uint16_t remaining_comm_bfr_sz_with_import_export;
-
-    //Import context to security chip and calculate hash
-    //Available_Size = (wMaxCommsBuffer - #CALC_HASH_FIXED_OVERHEAD_SIZE - #CALC_HASH_IMPORT_OR_EXPORT_OVERHEAD_SIZE - #CALC_HASH_SHA256_CONTEXT_SIZE)
-    uint16_t remaining_comm_bfr_sz_with_import;
-
-    //Calulate hash and export context out of security chip
-    //Available_Size = (wMaxCommsBuffer - CALC_HASH_FIXED_OVERHEAD_SIZE - CALC_HASH_IMPORT_OR_EXPORT_OVERHEAD_SIZE)
-    uint16_t remaining_comm_bfr_sz_with_export;
+    //Data size of the current command, reduced by the imported context and the export request
+    uint16_t chunk_size;
+    uint16_t last_chunk_size;
 
     uint32_t size_of_data_to_hash = 0;
-    uint8_t chaining = 0;
+    bool_t import_context = TRUE;
+    bool_t export_context = TRUE;
+    bool_t last_chunk = TRUE;
 
     hash_options.eHashAlg      = (eHashAlg_d)(hash_ctx->hash_algo);
     hash_options.eHashDataType = source_of_data_to_hash == OPTIGA_CRYPT_HOST_DATA?eDataStream:eOIDData;
@@ -124,40 +740,13 @@ optiga_lib_status_t optiga_crypt_hash_update(optiga_hash_context_t * hash_ctx,
     //Hash context
     hash_options.sContextInfo.pbContextData  = hash_ctx->context_buffer;
     hash_options.sContextInfo.dwContextLen   = hash_ctx->context_buffer_length;
-    hash_options.sContextInfo.eContextAction = eImportExport;
 
-    max_comms_buffer = CmdLib_GetMaxCommsBufferSize();
-
-    remaining_comm_bfr_sz_basic = max_comms_buffer - CALC_HASH_FIXED_OVERHEAD_SIZE;
-    remaining_comm_bfr_sz_with_import_export = max_comms_buffer -(CALC_HASH_FIXED_OVERHEAD_SIZE +   \
-                                               CALC_HASH_IMPORT_AND_EXPORT_OVERHEAD_SIZE +          \
-                                               CALC_HASH_SHA256_CONTEXT_SIZE);
-
-    remaining_comm_bfr_sz_with_import = max_comms_buffer -(CALC_HASH_FIXED_OVERHEAD_SIZE+   \
-                                        CALC_HASH_IMPORT_OR_EXPORT_OVERHEAD_SIZE+           \
-                                        CALC_HASH_SHA256_CONTEXT_SIZE);
-
-    remaining_comm_bfr_sz_with_export = max_comms_buffer -(CALC_HASH_FIXED_OVERHEAD_SIZE +  \
-                                        CALC_HASH_IMPORT_OR_EXPORT_OVERHEAD_SIZE);
+    remaining_comm_bfr_sz_basic = CmdLib_GetMaxCommsBufferSize() - CALC_HASH_FIXED_OVERHEAD_SIZE;
 
     if ((eDataType_d)source_of_data_to_hash == OPTIGA_CRYPT_HOST_DATA)
     {
         hash_options.sDataStream.prgbStream = (uint8_t *)(((hash_data_from_host_t *)data_to_hash)->buffer);
         size_of_data_to_hash       = ((hash_data_from_host_t *)data_to_hash)->length;
-        remaining_comm_buffer_size = size_of_data_to_hash;
-
-        //Verify whether (Import & export) + data options can be set in one command or not
-        if (remaining_comm_bfr_sz_with_import_export<size_of_data_to_hash)
-        {
-            chaining = 1;
-            remaining_comm_buffer_size = remaining_comm_bfr_sz_with_import;
-            if (remaining_comm_bfr_sz_with_import>size_of_data_to_hash)
-            {
-                remaining_comm_buffer_size = size_of_data_to_hash;
-            }
-            hash_options.sContextInfo.eContextAction = eImport;
-        }
-        hash_options.sDataStream.wLen = remaining_comm_buffer_size;
     }
     else
     {
@@ -166,46 +755,319 @@ optiga_lib_status_t optiga_crypt_hash_update(optiga_hash_context_t * hash_ctx,
         hash_options.sOIDData.wLength = ((hash_data_in_optiga_t *)data_to_hash)->length;
     }
 
-    while (1)
-    {   
-        while (pal_os_lock_acquire() != OPTIGA_LIB_SUCCESS);
-        return_value = CmdLib_CalcHash(&hash_options);
+    //The active hash context in OPTIGA is kept between the commands, so no other request may be served in between
+    while (pal_os_lock_acquire() != PAL_STATUS_SUCCESS);
+#ifdef OPTIGA_CRYPT_HASH_RESIDENT_CONTEXT
+    //The updated context is kept active in OPTIGA
+    return_value = optiga_crypt_hash_acquire(hash_ctx, FALSE, &hash_options.sContextInfo);
+    if (OPTIGA_LIB_SUCCESS != return_value)
+    {
         pal_os_lock_release();
-
+        return return_value;
+    }
+    import_context = (NULL != hash_options.sContextInfo.pbContextData) ? TRUE : FALSE;
+    export_context = FALSE;
+#endif
+    do
+    {
+        //The context is imported with the first command and exported with the last one
+        if ((eDataType_d)source_of_data_to_hash == OPTIGA_CRYPT_HOST_DATA)
+        {
+            chunk_size = remaining_comm_bfr_sz_basic - (import_context ? HASH_IMPORT_OVERHEAD : 0);
+            last_chunk_size = chunk_size - (export_context ? HASH_EXPORT_OVERHEAD : 0);
+            last_chunk = (size_of_data_to_hash <= last_chunk_size) ? TRUE : FALSE;
+            if (size_of_data_to_hash < chunk_size)
+            {
+                chunk_size = (uint16_t)size_of_data_to_hash;
+            }
+            hash_options.sDataStream.wLen = chunk_size;
+        }
+        hash_options.sContextInfo.eContextAction = optiga_crypt_hash_context_action(import_context,
+                                                                                    last_chunk && export_context);
+        return_value = optiga_crypt_calc_hash(&hash_options);
         if (CMD_LIB_OK != return_value)
         {
             break;
         }
 
-        if (!chaining)
+        if ((eDataType_d)source_of_data_to_hash == OPTIGA_CRYPT_HOST_DATA)
+        {
+            hash_options.sDataStream.prgbStream += chunk_size;
+            size_of_data_to_hash -= chunk_size;
+        }
+        import_context = FALSE;
+    } while (FALSE == last_chunk);
+#ifdef OPTIGA_CRYPT_HASH_RESIDENT_CONTEXT
+    optiga_crypt_hash_resident(hash_ctx, (CMD_LIB_OK == return_value));
+    hash_stats.update_count++;
+#endif
+    pal_os_lock_release();
+
+    if (CMD_LIB_OK == return_value)
+    {
+        return_value = OPTIGA_LIB_SUCCESS;
+    }
+    return return_value;
+}
+
+/// @cond hidden
+//Number of chunk buffers: the chunk hashed by OPTIGA, the chunk to be hashed next and the chunk being filled.
+//They and the buffer of the CalcHash command come from the APDU buffer pool, see CMDLIB_APDU_POOL_COUNT.
+#define HASH_STREAM_BUFFER_COUNT    3
+
+typedef struct optiga_crypt_hash_fill
+{
+    optiga_crypt_hash_source_t source;
+    void * p_ctx;
+    uint8_t * p_buffer;
+    uint16_t max_length;
+    uint16_t length;
+    optiga_lib_status_t status;
+    bool_t pending;
+} optiga_crypt_hash_fill_t;
+
+//Fills the pending chunk from the source, invoked while OPTIGA processes the previous chunk
+static void optiga_crypt_hash_fill(void * p_ctx)
+{
+    optiga_crypt_hash_fill_t * p_fill = (optiga_crypt_hash_fill_t *)p_ctx;
+
+    if (TRUE == p_fill->pending)
+    {
+        p_fill->pending = FALSE;
+        p_fill->length = p_fill->max_length;
+        p_fill->status = p_fill->source(p_fill->p_ctx, p_fill->p_buffer, &p_fill->length);
+        if ((OPTIGA_LIB_SUCCESS == p_fill->status) && (p_fill->length > p_fill->max_length))
+        {
+            p_fill->status = OPTIGA_LIB_ERROR;
+        }
+    }
+}
+
+static optiga_lib_status_t optiga_crypt_hash_chunk(sCalcHash_d * hash_options,
+                                                   uint8_t * p_data,
+                                                   uint16_t length,
+                                                   eContextAction_d context_action)
+{
+    hash_options->sDataStream.prgbStream     = p_data;
+    hash_options->sDataStream.wLen           = length;
+    hash_options->sContextInfo.eContextAction = context_action;
+
+    return optiga_crypt_calc_hash(hash_options);
+}
+/// @endcond
+
+optiga_lib_status_t optiga_crypt_hash_update_stream(optiga_hash_context_t * hash_ctx,
+                                                    optiga_crypt_hash_source_t source,
+                                                    void * p_ctx)
+{
+    optiga_lib_status_t return_value = OPTIGA_LIB_ERROR;
+    sCalcHash_d hash_options;
+    optiga_crypt_hash_fill_t fill;
+    uint8_t * chunk_buffer[HASH_STREAM_BUFFER_COUNT] = {NULL};
+    uint16_t chunk_length[HASH_STREAM_BUFFER_COUNT];
+    uint16_t max_comms_buffer;
+    //Data size of a chunk without context and of the first chunk
+    uint16_t size_basic;
+    uint16_t size_first;
+    uint16_t length;
+    uint16_t split_length;
+    uint8_t * p_data;
+    uint8_t current = 0;
+    uint8_t next;
+    uint8_t index;
+    bool_t first_chunk = TRUE;
+    bool_t last_chunk;
+    bool_t import_context = TRUE;
+#ifdef OPTIGA_CRYPT_HASH_RESIDENT_CONTEXT
+    optiga_crypt_hash_slot_t * slot;
+#endif
+    bool_t export_context = TRUE;
+    eContextAction_d context_action;
+
+    do
+    {
+        if ((NULL == hash_ctx) || (NULL == source))
+        {
+            break;
+        }
+
+        max_comms_buffer = CmdLib_GetMaxCommsBufferSize();
+        if ((0xFFFF == max_comms_buffer) ||
+            (max_comms_buffer <= (CALC_HASH_FIXED_OVERHEAD_SIZE + HASH_IMPORT_OVERHEAD + HASH_EXPORT_OVERHEAD)))
         {
-        	return_value = OPTIGA_LIB_SUCCESS;
             break;
         }
-        else
+        size_basic = max_comms_buffer - CALC_HASH_FIXED_OVERHEAD_SIZE;
+
+        for (index = 0; index < HASH_STREAM_BUFFER_COUNT; index++)
+        {
+            chunk_buffer[index] = CmdLib_GetApduBuffer(size_basic);
+            if (NULL == chunk_buffer[index])
+            {
+                break;
+            }
+        }
+        if (index < HASH_STREAM_BUFFER_COUNT)
         {
-            hash_options.sDataStream.prgbStream += remaining_comm_buffer_size;
-            size_of_data_to_hash -= remaining_comm_buffer_size;
+            break;
+        }
+        return_value = OPTIGA_LIB_SUCCESS;
+    } while (FALSE);
 
-            remaining_comm_buffer_size = size_of_data_to_hash;
-            hash_options.sContextInfo.eContextAction = eUnused;
-            //Verify whether export + data options can be set in one command or not
-            if (remaining_comm_bfr_sz_with_export < size_of_data_to_hash)
+    if (OPTIGA_LIB_SUCCESS != return_value)
+    {
+        for (index = 0; index < HASH_STREAM_BUFFER_COUNT; index++)
+        {
+            CmdLib_PutApduBuffer(chunk_buffer[index]);
+        }
+        return OPTIGA_LIB_ERROR;
+    }
+
+    fill.source = source;
+    fill.p_ctx  = p_ctx;
+
+    hash_options.eHashAlg      = (eHashAlg_d)(hash_ctx->hash_algo);
+    hash_options.eHashDataType = eDataStream;
+    hash_options.eHashSequence = eContinueHash;
+    hash_options.sContextInfo.pbContextData = hash_ctx->context_buffer;
+    hash_options.sContextInfo.dwContextLen  = hash_ctx->context_buffer_length;
+
+    //The active hash context in OPTIGA is kept between the chunks, so no other request may be served in between
+    while (pal_os_lock_acquire() != PAL_STATUS_SUCCESS);
+#ifdef OPTIGA_CRYPT_HASH_RESIDENT_CONTEXT
+    //The updated context is kept active in OPTIGA
+    return_value = optiga_crypt_hash_acquire(hash_ctx, FALSE, &hash_options.sContextInfo);
+    import_context = (NULL != hash_options.sContextInfo.pbContextData) ? TRUE : FALSE;
+    export_context = FALSE;
+#endif
+    size_first = size_basic - (import_context ? HASH_IMPORT_OVERHEAD : 0);
+    do
+    {
+#ifdef OPTIGA_CRYPT_HASH_RESIDENT_CONTEXT
+        if (OPTIGA_LIB_SUCCESS != return_value)
+        {
+            break;
+        }
+#endif
+        //The first chunk carries the imported context, the one after it is filled to know whether the first is the last
+        fill.p_buffer   = chunk_buffer[0];
+        fill.max_length = size_first;
+        fill.pending    = TRUE;
+        optiga_crypt_hash_fill(&fill);
+        if (OPTIGA_LIB_SUCCESS != fill.status)
+        {
+            return_value = fill.status;
+            break;
+        }
+        chunk_length[0] = fill.length;
+        chunk_length[1] = 0;
+        if (0 == chunk_length[0])
+        {
+            //No data, the hash context stays as it is
+            break;
+        }
+        if (size_first == chunk_length[0])
+        {
+            fill.p_buffer   = chunk_buffer[1];
+            fill.max_length = size_basic;
+            fill.pending    = TRUE;
+            optiga_crypt_hash_fill(&fill);
+            if (OPTIGA_LIB_SUCCESS != fill.status)
+            {
+                return_value = fill.status;
+                break;
+            }
+            chunk_length[1] = fill.length;
+        }
+
+        while (1)
+        {
+            next = (uint8_t)((current + 1) % HASH_STREAM_BUFFER_COUNT);
+            last_chunk = (0 == chunk_length[next]) ? TRUE : FALSE;
+
+            //Fill the chunk after the next one while OPTIGA hashes the current one, a short chunk ends the data
+            index = (uint8_t)((current + 2) % HASH_STREAM_BUFFER_COUNT);
+            chunk_length[index] = 0;
+            fill.p_buffer   = chunk_buffer[index];
+            fill.max_length = size_basic;
+            fill.length     = 0;
+            fill.status     = OPTIGA_LIB_SUCCESS;
+            fill.pending    = ((FALSE == last_chunk) && (size_basic == chunk_length[next])) ? TRUE : FALSE;
+            CmdLib_SetWaitHook(optiga_crypt_hash_fill, &fill);
+
+            p_data = chunk_buffer[current];
+            length = chunk_length[current];
+            context_action = optiga_crypt_hash_context_action(first_chunk && import_context, FALSE);
+            if (TRUE == last_chunk)
             {
-                remaining_comm_buffer_size = remaining_comm_bfr_sz_basic;
-                if (remaining_comm_bfr_sz_basic > size_of_data_to_hash)
+                //A last chunk which does not fit along with the exported context is split into two commands
+                split_length = size_basic - ((first_chunk && import_context) ? HASH_IMPORT_OVERHEAD : 0) -
+                               (export_context ? HASH_EXPORT_OVERHEAD : 0);
+                if (length > split_length)
                 {
-                    remaining_comm_buffer_size = size_of_data_to_hash;
+                    return_value = optiga_crypt_hash_chunk(&hash_options, p_data, length - split_length, context_action);
+                    if (CMD_LIB_OK != return_value)
+                    {
+                        break;
+                    }
+                    p_data += length - split_length;
+                    length = split_length;
+                    first_chunk = FALSE;
                 }
+                context_action = optiga_crypt_hash_context_action(first_chunk && import_context, export_context);
             }
-            else
+            return_value = optiga_crypt_hash_chunk(&hash_options, p_data, length, context_action);
+            if (CMD_LIB_OK != return_value)
             {
-                hash_options.sContextInfo.eContextAction = eExport;
-                chaining = 0;
+                break;
             }
-            hash_options.sDataStream.wLen = remaining_comm_buffer_size;
+            first_chunk = FALSE;
+
+            //Fill the chunk here if the hook was not invoked
+            CmdLib_SetWaitHook(NULL, NULL);
+            optiga_crypt_hash_fill(&fill);
+            if (OPTIGA_LIB_SUCCESS != fill.status)
+            {
+                return_value = fill.status;
+                break;
+            }
+            chunk_length[index] = fill.length;
+
+            if (TRUE == last_chunk)
+            {
+                return_value = OPTIGA_LIB_SUCCESS;
+                break;
+            }
+            current = next;
+        }
+    } while (FALSE);
+    CmdLib_SetWaitHook(NULL, NULL);
+#ifdef OPTIGA_CRYPT_HASH_RESIDENT_CONTEXT
+    if ((TRUE == first_chunk) && (OPTIGA_LIB_SUCCESS == return_value) && (TRUE == import_context))
+    {
+        //Nothing was sent as the source provided no data, the state to import stays where it was
+        slot = optiga_crypt_hash_find_slot(hash_ctx);
+        if (hash_options.sContextInfo.pbContextData == slot->context)
+        {
+            slot->parked = TRUE;
+        }
+        else
+        {
+            slot->p_owner = NULL;
         }
     }
+    else
+    {
+        optiga_crypt_hash_resident(hash_ctx, (OPTIGA_LIB_SUCCESS == return_value));
+    }
+    hash_stats.update_count++;
+#endif
+    pal_os_lock_release();
+
+    for (index = 0; index < HASH_STREAM_BUFFER_COUNT; index++)
+    {
+        CmdLib_PutApduBuffer(chunk_buffer[index]);
+    }
 
     return return_value;
 }
@@ -213,9 +1075,10 @@ optiga_lib_status_t optiga_crypt_hash_update(optiga_hash_context_t * hash_ctx,
 optiga_lib_status_t optiga_crypt_hash_finalize(optiga_hash_context_t * hash_ctx,
                                                uint8_t * hash_output)
 {
-    optiga_lib_status_t return_value;
+    optiga_lib_status_t return_value = OPTIGA_LIB_SUCCESS;
     uint8_t datastream[1];
     sCalcHash_d hash_options;
+    bool_t import_context = TRUE;
 
     hash_options.eHashAlg        = (eHashAlg_d)hash_ctx->hash_algo;
     hash_options.eHashDataType   =  eDataStream;
@@ -225,7 +1088,6 @@ optiga_lib_status_t optiga_crypt_hash_finalize(optiga_hash_context_t * hash_ctx,
 
     hash_options.sContextInfo.pbContextData  = hash_ctx->context_buffer;
     hash_options.sContextInfo.dwContextLen   = hash_ctx->context_buffer_length;
-    hash_options.sContextInfo.eContextAction = eImport;
     
     hash_options.sOutHash.prgbBuffer         = hash_output;
 	if(hash_options.eHashAlg == eSHA256)
@@ -233,10 +1095,53 @@ optiga_lib_status_t optiga_crypt_hash_finalize(optiga_hash_context_t * hash_ctx,
 		hash_options.sOutHash.wBufferLength  = 32;
 	}
 
-    while (pal_os_lock_acquire() != OPTIGA_LIB_SUCCESS);
-    return_value = CmdLib_CalcHash(&hash_options);
+    while (pal_os_lock_acquire() != PAL_STATUS_SUCCESS);
+#ifdef OPTIGA_CRYPT_HASH_RESIDENT_CONTEXT
+    return_value = optiga_crypt_hash_acquire(hash_ctx, FALSE, &hash_options.sContextInfo);
+    import_context = (NULL != hash_options.sContextInfo.pbContextData) ? TRUE : FALSE;
+#endif
+    if (OPTIGA_LIB_SUCCESS == return_value)
+    {
+        hash_options.sContextInfo.eContextAction = optiga_crypt_hash_context_action(import_context, FALSE);
+        return_value = optiga_crypt_calc_hash(&hash_options);
+        return_value = (CMD_LIB_OK == return_value) ? OPTIGA_LIB_SUCCESS : OPTIGA_LIB_ERROR;
+    }
+#ifdef OPTIGA_CRYPT_HASH_RESIDENT_CONTEXT
+    //The context is consumed by the finalization, also if it failed
+    optiga_crypt_hash_resident(hash_ctx, FALSE);
+#endif
+    pal_os_lock_release();
+
+    return return_value;
+}
+
+#ifdef OPTIGA_CRYPT_HASH_RESIDENT_CONTEXT
+optiga_lib_status_t optiga_crypt_hash_release(optiga_hash_context_t * hash_ctx)
+{
+    optiga_lib_status_t return_value = CMD_LIB_OK;
+    optiga_crypt_hash_slot_t * slot;
+
+    while (pal_os_lock_acquire() != PAL_STATUS_SUCCESS);
+    slot = optiga_crypt_hash_find_slot(hash_ctx);
+    if (NULL != slot)
+    {
+        if (hash_ctx == (optiga_hash_context_t *)CmdLib_GetHashContextOwner())
+        {
+            return_value = optiga_crypt_hash_evict();
+        }
+        if ((FALSE == slot->parked) || (hash_ctx->context_buffer_length < sizeof(slot->context)))
+        {
+            return_value = OPTIGA_LIB_ERROR;
+        }
+        else
+        {
+            memcpy(hash_ctx->context_buffer, slot->context, sizeof(slot->context));
+        }
+        memset(slot->context, 0, sizeof(slot->context));
+        slot->p_owner = NULL;
+    }
     pal_os_lock_release();
-    
+
     if (CMD_LIB_OK != return_value)
     {
         return OPTIGA_LIB_ERROR;
@@ -244,6 +1149,14 @@ optiga_lib_status_t optiga_crypt_hash_finalize(optiga_hash_context_t * hash_ctx,
     return OPTIGA_LIB_SUCCESS;
 }
 
+void optiga_crypt_hash_get_stats(optiga_crypt_hash_stats_t * p_stats)
+{
+    while (pal_os_lock_acquire() != PAL_STATUS_SUCCESS);
+    *p_stats = hash_stats;
+    pal_os_lock_release();
+}
+#endif
+
 optiga_lib_status_t optiga_crypt_ecc_generate_keypair(optiga_ecc_curve_t curve_id,
                                                       uint8_t key_usage,
                                                       bool_t export_private_key,
@@ -279,7 +1192,7 @@ optiga_lib_status_t optiga_crypt_ecc_generate_keypair(optiga_ecc_curve_t curve_i
 
 
 
-    while (pal_os_lock_acquire() != OPTIGA_LIB_SUCCESS);
+    while (pal_os_lock_acquire() != PAL_STATUS_SUCCESS);
     return_value = CmdLib_GenerateKeyPair(&keypair_options,&public_key_out);
     pal_os_lock_release();
 
@@ -311,7 +1224,7 @@ optiga_lib_status_t optiga_crypt_ecdsa_sign (uint8_t * digest,
     sign.prgbStream = signature;
     sign.wLen       =  *signature_length;
 
-    while (pal_os_lock_acquire() != OPTIGA_LIB_SUCCESS);
+    while (pal_os_lock_acquire() != PAL_STATUS_SUCCESS);
     return_value = CmdLib_CalculateSign(&sign_options,&sign);
     pal_os_lock_release();
 
@@ -323,6 +1236,224 @@ optiga_lib_status_t optiga_crypt_ecdsa_sign (uint8_t * digest,
     return OPTIGA_LIB_SUCCESS;
 }
 
+/// @cond hidden
+//Tag of a DER INTEGER
+#define DER_TAG_INTEGER                 (0x02)
+//Largest component of the supported curves (NIST P-384)
+#define ECDSA_MAX_COMPONENT_LENGTH      (48)
+//Signature from OPTIGA, two DER INTEGERs with tag, length and a leading zero for positive values
+#define ECDSA_MAX_SIGNATURE_LENGTH      (2 * (ECDSA_MAX_COMPONENT_LENGTH + 3))
+
+//Converts the signature from OPTIGA, two concatenated DER INTEGERs, to r||s with zero padded components
+static optiga_lib_status_t optiga_crypt_signature_to_raw(const uint8_t * der_signature,
+                                                         uint16_t der_signature_length,
+                                                         uint8_t * signature,
+                                                         uint16_t * signature_length,
+                                                         uint8_t component_length)
+{
+    uint16_t offset = 0;
+    uint8_t length;
+    uint8_t index;
+
+    if (*signature_length < (2 * component_length))
+    {
+        return OPTIGA_LIB_ERROR;
+    }
+    memset(signature, 0, 2 * component_length);
+
+    for (index = 0; index < 2; index++)
+    {
+        if (((offset + 2) > der_signature_length) || (DER_TAG_INTEGER != der_signature[offset]))
+        {
+            return OPTIGA_LIB_ERROR;
+        }
+        length = der_signature[offset + 1];
+        offset += 2;
+        if ((length & 0x80) || ((offset + length) > der_signature_length))
+        {
+            return OPTIGA_LIB_ERROR;
+        }
+        //Skip the leading zeros of the positive integer
+        while ((length > component_length) && (0x00 == der_signature[offset]))
+        {
+            offset++;
+            length--;
+        }
+        if (length > component_length)
+        {
+            return OPTIGA_LIB_ERROR;
+        }
+        memcpy(signature + (index * component_length) + (component_length - length), &der_signature[offset], length);
+        offset += length;
+    }
+    if (offset != der_signature_length)
+    {
+        return OPTIGA_LIB_ERROR;
+    }
+
+    *signature_length = 2 * component_length;
+    return OPTIGA_LIB_SUCCESS;
+}
+/// @endcond
+
+optiga_lib_status_t optiga_crypt_ecdsa_sign_batch(optiga_crypt_sign_item_t * p_items,
+                                                  uint16_t item_count,
+                                                  optiga_key_id_t private_key,
+                                                  uint8_t raw_component_length)
+{
+    optiga_lib_status_t return_value = OPTIGA_LIB_SUCCESS;
+    sbBlob_d sign;
+    sCalcSignOptions_d sign_options;
+    uint8_t der_signature[ECDSA_MAX_SIGNATURE_LENGTH];
+    optiga_crypt_sign_item_t * p_item;
+    uint16_t index;
+
+    if ((NULL == p_items) || (0 == item_count) || (raw_component_length > ECDSA_MAX_COMPONENT_LENGTH))
+    {
+        return OPTIGA_LIB_ERROR;
+    }
+
+    sign_options.eSignScheme = eECDSA_FIPS_186_3_WITHOUT_HASH;
+    sign_options.wOIDSignKey = private_key;
+
+    //One lock hold for all the signatures, the APDU buffer is taken from the CommandLib pool per signature
+    while (pal_os_lock_acquire() != PAL_STATUS_SUCCESS);
+    for (index = 0; index < item_count; index++)
+    {
+        p_item = &p_items[index];
+        p_item->status = OPTIGA_LIB_ERROR;
+        if ((NULL == p_item->digest) || (NULL == p_item->signature))
+        {
+            p_item->signature_length = 0;
+            return_value = OPTIGA_LIB_ERROR;
+            continue;
+        }
+
+        sign_options.sDigestToSign.prgbStream = p_item->digest;
+        sign_options.sDigestToSign.wLen       = p_item->digest_length;
+
+        //A raw signature is converted from the DER encoded one
+        sign.prgbStream = (0 != raw_component_length) ? der_signature : p_item->signature;
+        sign.wLen       = (0 != raw_component_length) ? sizeof(der_signature) : p_item->signature_length;
+
+        if (CMD_LIB_OK == CmdLib_CalculateSign(&sign_options,&sign))
+        {
+            if (0 != raw_component_length)
+            {
+                p_item->status = optiga_crypt_signature_to_raw(der_signature, sign.wLen, p_item->signature,
+                                                               &p_item->signature_length, raw_component_length);
+            }
+            else
+            {
+                p_item->signature_length = sign.wLen;
+                p_item->status = OPTIGA_LIB_SUCCESS;
+            }
+        }
+        if (OPTIGA_LIB_SUCCESS != p_item->status)
+        {
+            p_item->signature_length = 0;
+            return_value = OPTIGA_LIB_ERROR;
+        }
+    }
+    pal_os_lock_release();
+
+    memset(der_signature, 0, sizeof(der_signature));
+    return return_value;
+}
+
+/// @cond hidden
+#ifdef PAL_OS_HAS_CRITICAL_SECTION
+#define SIGN_QUEUE_ENTER_CRITICAL()             pal_os_lock_enter_critical_section()
+#define SIGN_QUEUE_EXIT_CRITICAL()              pal_os_lock_exit_critical_section()
+#else
+#define SIGN_QUEUE_ENTER_CRITICAL()
+#define SIGN_QUEUE_EXIT_CRITICAL()
+#endif
+
+//Number of queued signatures, the lock is held while it is not 0
+static uint16_t sign_queue_count = 0;
+
+//Counts a request out, releases the lock after the last one
+static void optiga_crypt_sign_queue_leave(void)
+{
+    bool_t last;
+
+    SIGN_QUEUE_ENTER_CRITICAL();
+    last = (0 == --sign_queue_count) ? TRUE : FALSE;
+    SIGN_QUEUE_EXIT_CRITICAL();
+
+    if (last)
+    {
+        pal_os_lock_release();
+    }
+}
+
+static void optiga_crypt_sign_request_handler(void * p_ctx, int32_t status)
+{
+    optiga_crypt_sign_request_t * p_request = (optiga_crypt_sign_request_t *)p_ctx;
+
+    /*
+     * The request is counted out after the handler, so a signature queued by the handler joins the running queue
+     * and its submission does not wait for the lock in the event context.
+     */
+    p_request->handler(p_request->p_ctx, (CMD_LIB_OK == status) ? OPTIGA_LIB_SUCCESS : status,
+                       (CMD_LIB_OK == status) ? p_request->signature.wLen : 0);
+    optiga_crypt_sign_queue_leave();
+}
+/// @endcond
+
+optiga_lib_status_t optiga_crypt_ecdsa_sign_submit(optiga_crypt_sign_request_t * p_request,
+                                                   uint8_t * digest,
+                                                   uint8_t digest_length,
+                                                   optiga_key_id_t private_key,
+                                                   uint8_t * signature,
+                                                   uint16_t signature_length,
+                                                   optiga_crypt_sign_handler_t handler,
+                                                   void * p_ctx)
+{
+    sCalcSignOptions_d sign_options;
+    bool_t first;
+
+    if ((NULL == p_request) || (NULL == digest) || (NULL == signature) || (NULL == handler))
+    {
+        return OPTIGA_LIB_ERROR;
+    }
+
+    sign_options.eSignScheme = eECDSA_FIPS_186_3_WITHOUT_HASH;
+    sign_options.wOIDSignKey = private_key;
+    sign_options.sDigestToSign.prgbStream = digest;
+    sign_options.sDigestToSign.wLen = digest_length;
+
+    p_request->signature.prgbStream = signature;
+    p_request->signature.wLen = signature_length;
+    p_request->handler = handler;
+    p_request->p_ctx = p_ctx;
+
+    //The first request takes the lock for all the requests queued until the queue drains
+    SIGN_QUEUE_ENTER_CRITICAL();
+    first = (0 == sign_queue_count) ? TRUE : FALSE;
+    if (!first)
+    {
+        sign_queue_count++;
+    }
+    SIGN_QUEUE_EXIT_CRITICAL();
+    if (first)
+    {
+        while (pal_os_lock_acquire() != PAL_STATUS_SUCCESS);
+        SIGN_QUEUE_ENTER_CRITICAL();
+        sign_queue_count++;
+        SIGN_QUEUE_EXIT_CRITICAL();
+    }
+
+    if (CMD_LIB_OK != CmdLib_SubmitCalculateSign(&sign_options, &p_request->signature, &p_request->cmd_request,
+                                                 optiga_crypt_sign_request_handler, p_request))
+    {
+        optiga_crypt_sign_queue_leave();
+        return OPTIGA_LIB_ERROR;
+    }
+    return OPTIGA_LIB_SUCCESS;
+}
+
 optiga_lib_status_t optiga_crypt_ecdsa_verify (uint8_t * digest,
                                                uint8_t digest_length,
                                                uint8_t * signature,
@@ -355,7 +1486,7 @@ optiga_lib_status_t optiga_crypt_ecdsa_verify (uint8_t * digest,
     sign.prgbStream = signature;
     sign.wLen       = signature_length;
 
-    while (pal_os_lock_acquire() != OPTIGA_LIB_SUCCESS);
+    while (pal_os_lock_acquire() != PAL_STATUS_SUCCESS);
     return_value = CmdLib_VerifySign(&verifysign_options, &dgst, &sign);
     pal_os_lock_release();
 
@@ -396,7 +1527,7 @@ optiga_lib_status_t optiga_crypt_ecdh(optiga_key_id_t private_key,
         shared_secret_options.wOIDSharedSecret = *((uint16_t *)shared_secret);
     }
 
-    while (pal_os_lock_acquire() != OPTIGA_LIB_SUCCESS);
+    while (pal_os_lock_acquire() != PAL_STATUS_SUCCESS);
     return_value = CmdLib_CalculateSharedSecret(&shared_secret_options, &sharedsecret);
     pal_os_lock_release();
 
@@ -408,6 +1539,262 @@ optiga_lib_status_t optiga_crypt_ecdh(optiga_key_id_t private_key,
     return return_value;
 }
 
+#ifdef OPTIGA_CRYPT_ECDH_POOL_SLOTS
+/// @cond hidden
+#if (OPTIGA_CRYPT_ECDH_POOL_SLOTS < 1) || (OPTIGA_CRYPT_ECDH_POOL_SLOTS > 4)
+#error "OPTIGA_CRYPT_ECDH_POOL_SLOTS must be in the range of 1 - 4"
+#endif
+
+//Time in milliseconds after which a key pair not given back is taken for another request
+#ifndef OPTIGA_CRYPT_ECDH_POOL_LEASE_TIME
+#define OPTIGA_CRYPT_ECDH_POOL_LEASE_TIME   (60000)
+#endif
+
+//Public key of NIST P-384 as BIT STRING, tag, length, unused bits and the uncompressed point
+#define ECDH_POOL_PUBLIC_KEY_LENGTH     (3 + 1 + (2 * 48))
+
+//States of a session slot
+#define ECDH_POOL_SLOT_FREE             (0x00)
+#define ECDH_POOL_SLOT_READY            (0x01)
+#define ECDH_POOL_SLOT_IN_USE           (0x02)
+
+typedef struct ecdh_pool_slot
+{
+    uint8_t state;
+    optiga_ecc_curve_t curve;
+    //Time the key pair was handed out, valid if in use
+    uint32_t acquire_time;
+    uint16_t public_key_length;
+    uint8_t public_key[ECDH_POOL_PUBLIC_KEY_LENGTH];
+} ecdh_pool_slot_t;
+
+//The slots and the statistics are protected by the PAL lock
+static ecdh_pool_slot_t ecdh_pool[OPTIGA_CRYPT_ECDH_POOL_SLOTS];
+static optiga_crypt_ecdh_pool_stats_t ecdh_pool_stats;
+
+//Returns the first slot in the given state (for the given curve if ready), OPTIGA_CRYPT_ECDH_POOL_SLOTS if none
+static uint8_t optiga_crypt_ecdh_pool_find(uint8_t state, optiga_ecc_curve_t curve_id)
+{
+    uint8_t index;
+
+    for (index = 0; index < OPTIGA_CRYPT_ECDH_POOL_SLOTS; index++)
+    {
+        if ((state == ecdh_pool[index].state) &&
+            ((ECDH_POOL_SLOT_READY != state) || (curve_id == ecdh_pool[index].curve)))
+        {
+            break;
+        }
+    }
+    return index;
+}
+
+/*
+ * Returns a slot to generate a key pair on demand, OPTIGA_CRYPT_ECDH_POOL_SLOTS if none. A free slot is taken first,
+ * then a key pair prepared for the other curve and then a key pair not given back within the lease time.
+ */
+static uint8_t optiga_crypt_ecdh_pool_reclaim(optiga_ecc_curve_t curve_id, uint32_t time)
+{
+    uint8_t index = optiga_crypt_ecdh_pool_find(ECDH_POOL_SLOT_FREE, curve_id);
+
+    if (OPTIGA_CRYPT_ECDH_POOL_SLOTS == index)
+    {
+        for (index = 0; index < OPTIGA_CRYPT_ECDH_POOL_SLOTS; index++)
+        {
+            if ((ECDH_POOL_SLOT_READY == ecdh_pool[index].state) && (curve_id != ecdh_pool[index].curve))
+            {
+                break;
+            }
+        }
+    }
+    if (OPTIGA_CRYPT_ECDH_POOL_SLOTS == index)
+    {
+        for (index = 0; index < OPTIGA_CRYPT_ECDH_POOL_SLOTS; index++)
+        {
+            if ((ECDH_POOL_SLOT_IN_USE == ecdh_pool[index].state) &&
+                ((time - ecdh_pool[index].acquire_time) >= OPTIGA_CRYPT_ECDH_POOL_LEASE_TIME))
+            {
+                ecdh_pool_stats.reclaim_count++;
+                break;
+            }
+        }
+    }
+    return index;
+}
+
+//Generates a key pair into the session context of the slot, called with the lock held
+static optiga_lib_status_t optiga_crypt_ecdh_pool_generate(uint8_t index, optiga_ecc_curve_t curve_id)
+{
+    sKeyPairOption_d keypair_options;
+    sOutKeyPair_d public_key_out;
+    ecdh_pool_slot_t * p_slot = &ecdh_pool[index];
+
+    keypair_options.eAlgId      = (eAlgId_d)curve_id;
+    keypair_options.eKeyUsage   = (eKeyUsage_d)OPTIGA_KEY_USAGE_KEY_AGREEMENT;
+    keypair_options.eKeyExport  = eStorePrivKeyOnly;
+    keypair_options.wOIDPrivKey = (uint16_t)(OPTIGA_SESSION_ID_E100 + index);
+
+    public_key_out.sPublicKey.prgbStream = p_slot->public_key;
+    public_key_out.sPublicKey.wLen       = sizeof(p_slot->public_key);
+
+    ecdh_pool_stats.keygen_count++;
+    if (CMD_LIB_OK != CmdLib_GenerateKeyPair(&keypair_options, &public_key_out))
+    {
+        p_slot->state = ECDH_POOL_SLOT_FREE;
+        return OPTIGA_LIB_ERROR;
+    }
+
+    p_slot->curve = curve_id;
+    p_slot->public_key_length = public_key_out.sPublicKey.wLen;
+    p_slot->state = ECDH_POOL_SLOT_READY;
+    return OPTIGA_LIB_SUCCESS;
+}
+/// @endcond
+
+optiga_lib_status_t optiga_crypt_ecdh_pool_fill(optiga_ecc_curve_t curve_id, uint8_t slot_count)
+{
+    optiga_lib_status_t return_value = OPTIGA_LIB_SUCCESS;
+    uint8_t ready_count;
+    uint8_t index;
+
+    //The lock is released after each key pair, so that a handshake is not delayed by more than one generation
+    while (OPTIGA_LIB_SUCCESS == return_value)
+    {
+        while (pal_os_lock_acquire() != PAL_STATUS_SUCCESS);
+        ready_count = 0;
+        for (index = 0; index < OPTIGA_CRYPT_ECDH_POOL_SLOTS; index++)
+        {
+            if ((ECDH_POOL_SLOT_READY == ecdh_pool[index].state) && (curve_id == ecdh_pool[index].curve))
+            {
+                ready_count++;
+            }
+        }
+        index = optiga_crypt_ecdh_pool_find(ECDH_POOL_SLOT_FREE, curve_id);
+        if ((ready_count >= slot_count) || (OPTIGA_CRYPT_ECDH_POOL_SLOTS == index))
+        {
+            pal_os_lock_release();
+            break;
+        }
+        return_value = optiga_crypt_ecdh_pool_generate(index, curve_id);
+        pal_os_lock_release();
+    }
+
+    return return_value;
+}
+
+optiga_lib_status_t optiga_crypt_ecdh_pool_acquire(optiga_ecc_curve_t curve_id,
+                                                   optiga_key_id_t * private_key,
+                                                   uint8_t * public_key,
+                                                   uint16_t * public_key_length)
+{
+    optiga_lib_status_t return_value = OPTIGA_LIB_SUCCESS;
+    uint32_t start_time = pal_os_timer_get_time_in_milliseconds();
+    uint32_t latency;
+    uint8_t index;
+    sKeyPairOption_d keypair_options;
+    sOutKeyPair_d public_key_out;
+
+    if ((NULL == private_key) || (NULL == public_key) || (NULL == public_key_length))
+    {
+        return OPTIGA_LIB_ERROR;
+    }
+
+    while (pal_os_lock_acquire() != PAL_STATUS_SUCCESS);
+    index = optiga_crypt_ecdh_pool_find(ECDH_POOL_SLOT_READY, curve_id);
+    if (OPTIGA_CRYPT_ECDH_POOL_SLOTS == index)
+    {
+        //No key pair prepared, it is generated on demand
+        ecdh_pool_stats.pool_miss_count++;
+        index = optiga_crypt_ecdh_pool_reclaim(curve_id, start_time);
+        if (OPTIGA_CRYPT_ECDH_POOL_SLOTS != index)
+        {
+            return_value = optiga_crypt_ecdh_pool_generate(index, curve_id);
+        }
+    }
+    if (OPTIGA_CRYPT_ECDH_POOL_SLOTS == index)
+    {
+        //All slots are in use, the key pair is generated into the key store like without the pool
+        keypair_options.eAlgId      = (eAlgId_d)curve_id;
+        keypair_options.eKeyUsage   = (eKeyUsage_d)OPTIGA_KEY_USAGE_KEY_AGREEMENT;
+        keypair_options.eKeyExport  = eStorePrivKeyOnly;
+        keypair_options.wOIDPrivKey = (uint16_t)OPTIGA_KEY_STORE_ID_E0F3;
+
+        public_key_out.sPublicKey.prgbStream = public_key;
+        public_key_out.sPublicKey.wLen       = *public_key_length;
+
+        ecdh_pool_stats.keygen_count++;
+        return_value = OPTIGA_LIB_ERROR;
+        if (CMD_LIB_OK == CmdLib_GenerateKeyPair(&keypair_options, &public_key_out))
+        {
+            *public_key_length = public_key_out.sPublicKey.wLen;
+            *private_key = OPTIGA_KEY_STORE_ID_E0F3;
+            return_value = OPTIGA_LIB_SUCCESS;
+        }
+    }
+    else if ((OPTIGA_LIB_SUCCESS == return_value) && (*public_key_length < ecdh_pool[index].public_key_length))
+    {
+        //The key pair stays ready for the next request
+        return_value = OPTIGA_LIB_ERROR;
+    }
+    else if (OPTIGA_LIB_SUCCESS == return_value)
+    {
+        memcpy(public_key, ecdh_pool[index].public_key, ecdh_pool[index].public_key_length);
+        *public_key_length = ecdh_pool[index].public_key_length;
+        *private_key = (optiga_key_id_t)(OPTIGA_SESSION_ID_E100 + index);
+        ecdh_pool[index].state = ECDH_POOL_SLOT_IN_USE;
+        ecdh_pool[index].acquire_time = start_time;
+    }
+
+    latency = pal_os_timer_get_time_in_milliseconds() - start_time;
+    ecdh_pool_stats.acquire_count++;
+    ecdh_pool_stats.total_latency += latency;
+    if (latency > ecdh_pool_stats.max_latency)
+    {
+        ecdh_pool_stats.max_latency = latency;
+    }
+    pal_os_lock_release();
+
+    return return_value;
+}
+
+optiga_lib_status_t optiga_crypt_ecdh_pool_release(optiga_key_id_t private_key)
+{
+    uint16_t index = (uint16_t)private_key - OPTIGA_SESSION_ID_E100;
+
+    if (OPTIGA_KEY_STORE_ID_E0F3 == private_key)
+    {
+        //Generated into the key store as no slot was available, nothing to give back
+        return OPTIGA_LIB_SUCCESS;
+    }
+    if (((uint16_t)private_key < OPTIGA_SESSION_ID_E100) || (index >= OPTIGA_CRYPT_ECDH_POOL_SLOTS))
+    {
+        return OPTIGA_LIB_ERROR;
+    }
+
+    //The private key stays in the session context until it is overwritten by the next generation
+    while (pal_os_lock_acquire() != PAL_STATUS_SUCCESS);
+    ecdh_pool[index].state = ECDH_POOL_SLOT_FREE;
+    pal_os_lock_release();
+
+    return OPTIGA_LIB_SUCCESS;
+}
+
+void optiga_crypt_ecdh_pool_get_stats(optiga_crypt_ecdh_pool_stats_t * p_stats)
+{
+    uint8_t index;
+
+    while (pal_os_lock_acquire() != PAL_STATUS_SUCCESS);
+    ecdh_pool_stats.ready_count = 0;
+    for (index = 0; index < OPTIGA_CRYPT_ECDH_POOL_SLOTS; index++)
+    {
+        if (ECDH_POOL_SLOT_READY == ecdh_pool[index].state)
+        {
+            ecdh_pool_stats.ready_count++;
+        }
+    }
+    *p_stats = ecdh_pool_stats;
+    pal_os_lock_release();
+}
+#endif
 
 optiga_lib_status_t optiga_crypt_tls_prf_sha256(uint16_t secret,
                                                 uint8_t * label,
@@ -445,7 +1832,7 @@ optiga_lib_status_t optiga_crypt_tls_prf_sha256(uint16_t secret,
 		derivekey_options.wOIDDerivedKey = *((uint16_t *)derived_key);
     }
 
-    while (pal_os_lock_acquire() != OPTIGA_LIB_SUCCESS);
+    while (pal_os_lock_acquire() != PAL_STATUS_SUCCESS);
     return_value = CmdLib_DeriveKey(&derivekey_options, &derivekey_output_buffer);
     pal_os_lock_release();
 
@@ -456,3 +1843,131 @@ optiga_lib_status_t optiga_crypt_tls_prf_sha256(uint16_t secret,
 
     return return_value;
 }
+
+/// @cond hidden
+//Length of the TLS 1.2 master secret
+#define TLS12_MASTER_SECRET_LENGTH      (48)
+//Length of the client and server randoms
+#define TLS12_RANDOM_LENGTH             (32)
+//Length of the labels "master secret" and "key expansion"
+#define TLS12_LABEL_LENGTH              (13)
+
+static optiga_crypt_tls12_key_schedule_stats_t tls12_key_schedule_stats;
+
+//Accumulates the time since *p_time into *p_latency and restarts *p_time
+static void optiga_crypt_tls12_key_schedule_time(uint32_t * p_time, uint32_t * p_latency)
+{
+    uint32_t now = pal_os_timer_get_time_in_milliseconds();
+
+    *p_latency += now - *p_time;
+    *p_time = now;
+}
+/// @endcond
+
+optiga_lib_status_t optiga_crypt_tls12_key_schedule(optiga_key_id_t private_key,
+                                                    public_key_from_host_t * public_key,
+                                                    optiga_key_id_t session_id,
+                                                    const uint8_t * client_random,
+                                                    const uint8_t * server_random,
+                                                    uint8_t * key_block,
+                                                    uint16_t key_block_length)
+{
+    int32_t return_value;
+    sCalcSSecOptions_d shared_secret_options;
+    sDeriveKeyOptions_d derivekey_options;
+    sbBlob_d derivekey_output_buffer = {0, NULL};
+    //Label and randoms, reused for the master secret and the key expansion
+    uint8_t seed[TLS12_LABEL_LENGTH + (2 * TLS12_RANDOM_LENGTH)];
+    uint32_t start_time;
+    uint32_t step_time;
+    uint32_t latency;
+
+    if ((NULL == public_key) || (NULL == client_random) || (NULL == server_random) ||
+        (NULL == key_block) || (key_block_length < 16))
+    {
+        return OPTIGA_LIB_ERROR;
+    }
+#ifdef OPTIGA_CRYPT_ECDH_POOL_SLOTS
+    //The key pair of another pool slot would be overwritten
+    if ((session_id != private_key) && ((uint16_t)session_id >= OPTIGA_SESSION_ID_E100) &&
+        ((uint16_t)session_id < (OPTIGA_SESSION_ID_E100 + OPTIGA_CRYPT_ECDH_POOL_SLOTS)))
+    {
+        return OPTIGA_LIB_ERROR;
+    }
+#endif
+
+    //The premaster secret is stored in the session context, it is not exported
+    shared_secret_options.eKeyAgreementType  = eECDH_NISTSP80056A;
+    shared_secret_options.wOIDPrivKey        = private_key;
+    shared_secret_options.ePubKeyAlgId       = (eAlgId_d)public_key->curve;
+    shared_secret_options.sPubKey.prgbStream = public_key->public_key;
+    shared_secret_options.sPubKey.wLen       = public_key->length;
+    shared_secret_options.wOIDSharedSecret   = session_id;
+
+    //master_secret = PRF(pre_master_secret, "master secret", ClientHello.random + ServerHello.random)
+    memcpy(seed, "master secret", TLS12_LABEL_LENGTH);
+    memcpy(&seed[TLS12_LABEL_LENGTH], client_random, TLS12_RANDOM_LENGTH);
+    memcpy(&seed[TLS12_LABEL_LENGTH + TLS12_RANDOM_LENGTH], server_random, TLS12_RANDOM_LENGTH);
+
+    derivekey_options.eKDM             = eTLS_PRF_SHA256;
+    derivekey_options.sSeed.prgbStream = seed;
+    derivekey_options.sSeed.wLen       = sizeof(seed);
+    derivekey_options.wOIDSharedSecret = session_id;
+    derivekey_options.wDerivedKeyLen   = TLS12_MASTER_SECRET_LENGTH;
+    derivekey_options.wOIDDerivedKey   = session_id;
+
+    while (pal_os_lock_acquire() != PAL_STATUS_SUCCESS);
+    start_time = pal_os_timer_get_time_in_milliseconds();
+    step_time = start_time;
+    do
+    {
+        return_value = CmdLib_CalculateSharedSecret(&shared_secret_options, &derivekey_output_buffer);
+        optiga_crypt_tls12_key_schedule_time(&step_time, &tls12_key_schedule_stats.shared_secret_latency);
+        if (CMD_LIB_OK != return_value)
+        {
+            break;
+        }
+
+        return_value = CmdLib_DeriveKey(&derivekey_options, &derivekey_output_buffer);
+        optiga_crypt_tls12_key_schedule_time(&step_time, &tls12_key_schedule_stats.master_secret_latency);
+        if (CMD_LIB_OK != return_value)
+        {
+            break;
+        }
+
+        //key_block = PRF(master_secret, "key expansion", ServerHello.random + ClientHello.random)
+        memcpy(seed, "key expansion", TLS12_LABEL_LENGTH);
+        memcpy(&seed[TLS12_LABEL_LENGTH], server_random, TLS12_RANDOM_LENGTH);
+        memcpy(&seed[TLS12_LABEL_LENGTH + TLS12_RANDOM_LENGTH], client_random, TLS12_RANDOM_LENGTH);
+        derivekey_options.wDerivedKeyLen   = key_block_length;
+        derivekey_options.wOIDDerivedKey   = 0x0000;
+        derivekey_output_buffer.prgbStream = key_block;
+        derivekey_output_buffer.wLen       = key_block_length;
+
+        return_value = CmdLib_DeriveKey(&derivekey_options, &derivekey_output_buffer);
+        optiga_crypt_tls12_key_schedule_time(&step_time, &tls12_key_schedule_stats.key_expansion_latency);
+    } while (FALSE);
+
+    latency = step_time - start_time;
+    tls12_key_schedule_stats.schedule_count++;
+    if (CMD_LIB_OK != return_value)
+    {
+        tls12_key_schedule_stats.failure_count++;
+    }
+    tls12_key_schedule_stats.total_latency += latency;
+    if (latency > tls12_key_schedule_stats.max_latency)
+    {
+        tls12_key_schedule_stats.max_latency = latency;
+    }
+    pal_os_lock_release();
+
+    memset(seed, 0, sizeof(seed));
+    return (CMD_LIB_OK == return_value) ? OPTIGA_LIB_SUCCESS : OPTIGA_LIB_ERROR;
+}
+
+void optiga_crypt_tls12_key_schedule_get_stats(optiga_crypt_tls12_key_schedule_stats_t * p_stats)
+{
+    while (pal_os_lock_acquire() != PAL_STATUS_SUCCESS);
+    *p_stats = tls12_key_schedule_stats;
+    pal_os_lock_release();
+}
@@ -98,6 +98,16 @@
 ///Overhead for import and export hash context
 #define CALC_HASH_IMPORT_AND_EXPORT_OVERHEAD_SIZE  (0x06)
 
+/**
+ * Number of APDU buffers preallocated when the application is opened (at most 8).<br>
+ * Each command takes one buffer while it runs. optiga_crypt_hash_update_stream holds three more and each
+ * running optiga_util_read_data_stream or optiga_util_write_data_stream one more. Requests beyond the pool
+ * are served by OCP_MALLOC. The default covers one hashed stream, or three data streams at the same time.
+ */
+#ifndef CMDLIB_APDU_POOL_COUNT
+#define CMDLIB_APDU_POOL_COUNT                  4
+#endif
+
 /****************************************************************************
  *
  * Common data structure used across all functions.
@@ -157,6 +167,36 @@ LIBRARY_EXPORTS int32_t CmdLib_OpenApplication(const sOpenApp_d* PpsOpenApp);
 /// @cond hidden
 LIBRARY_EXPORTS void CmdLib_SetOptigaCommsContext(const optiga_comms_t *p_input_optiga_comms);
 /// @endcond 
+
+/**
+ * \brief Takes a buffer for an APDU from the APDU buffer pool.
+ */
+LIBRARY_EXPORTS uint8_t* CmdLib_GetApduBuffer(uint16_t wLen);
+
+/**
+ * \brief Returns a buffer taken with #CmdLib_GetApduBuffer.
+ */
+LIBRARY_EXPORTS void CmdLib_PutApduBuffer(uint8_t* pbBuffer);
+
+/**
+ * \brief Function to be invoked while a command is processed by the security chip.
+ */
+typedef Void (*pFnWaitHook_d)(Void* pvCtx);
+
+/**
+ * \brief Sets the function invoked after a command is sent and before its response is awaited.
+ */
+LIBRARY_EXPORTS void CmdLib_SetWaitHook(pFnWaitHook_d pfWaitHook, Void* pvCtx);
+
+/**
+ * \brief Sets the owner of the hash context kept active in the security chip.
+ */
+LIBRARY_EXPORTS void CmdLib_SetHashContextOwner(Void* pvOwner);
+
+/**
+ * \brief Gets the owner of the hash context kept active in the security chip.
+ */
+LIBRARY_EXPORTS Void* CmdLib_GetHashContextOwner(void);
 /****************************************************************************
  *
  * Definitions related to GetDataObject and SetDataObject commands.
@@ -612,6 +652,44 @@ typedef struct sCalcSignOptions_d
 	sbBlob_d sDigestToSign;
 }sCalcSignOptions_d;
 
+/**
+ * \brief Function invoked when a request submitted with #CmdLib_SubmitCalculateSign completes.
+ */
+typedef Void (*pFnCmdLibHandler_d)(Void* pvCtx, int32_t i4Status);
+
+///Size of the APDU buffer of a signature request, the response is larger than the command for digests up to 64 bytes
+#define LEN_SIGN_REQUEST_APDU           (0x04 + 0x77)
+
+/**
+ * \brief Structure to hold a signature request queued with #CmdLib_SubmitCalculateSign.
+ */
+typedef struct sCmdLibSignRequest_d
+{
+	///APDU buffer, holding the command and then the response
+	uint8_t rgbApdu[LEN_SIGN_REQUEST_APDU];
+
+	///Segment of the command
+	sbBlob_d sTxSegment;
+
+	///Segment of the response
+	sbBlob_d sRxSegment;
+
+	///Request queued in optiga comms
+	optiga_comms_request_t sCommsRequest;
+
+	///Buffer receiving the signature
+	sbBlob_d* psSignature;
+
+	///Completion handler
+	pFnCmdLibHandler_d pfHandler;
+
+	///Context passed to the completion handler
+	Void* pvCtx;
+
+	///TRUE while the error code object is read after a failed command
+	bool_t bReadError;
+}sCmdLibSignRequest_d;
+
 /**
  * \brief Enumeration to specify supported key agreement primitives
  */
@@ -693,6 +771,13 @@ LIBRARY_EXPORTS int32_t CmdLib_GenerateKeyPair(const sKeyPairOption_d* PpsKeyPai
  */
 LIBRARY_EXPORTS int32_t CmdLib_CalculateSign(const sCalcSignOptions_d *PpsCalcSign,sbBlob_d *PpsSignature);
 
+/**
+ * \brief  Queues a CalcSign command to the Security Chip, completed through a handler.
+ */
+LIBRARY_EXPORTS int32_t CmdLib_SubmitCalculateSign(const sCalcSignOptions_d *PpsCalcSign, sbBlob_d *PpsSignature,
+                                                   sCmdLibSignRequest_d *PpsRequest, pFnCmdLibHandler_d pfHandler,
+                                                   Void* pvCtx);
+
 /**
  * \brief  Calculate shared secret by issuing CalcSSec command to the Security Chip.
  */
@@ -34,6 +34,64 @@
 #ifndef _MEMMGMT_H_
 #define _MEMMGMT_H_
 
+#ifdef OCP_USE_ALLOCATOR_HOOKS
+
+#include "optiga/common/Datatypes.h"
+
+/**
+ * \brief Allocator the OCP_MALLOC, OCP_CALLOC and OCP_FREE macros are routed to (e.g. a static arena).
+ */
+typedef struct sOcpAllocator_d
+{
+    ///Allocates wSize bytes, returns NULL if not available
+    Void* (*pfMalloc)(Void* pCtx, size_t wSize);
+    ///Frees the memory returned by pfMalloc
+    Void (*pfFree)(Void* pCtx, Void* pMemory);
+    ///Context passed to the functions
+    Void* pCtx;
+}sOcpAllocator_d;
+
+/**
+ * \brief Allocation counters of OCP_MALLOC, OCP_CALLOC and OCP_FREE.
+ */
+typedef struct sOcpAllocStats_d
+{
+    ///Number of successful allocations
+    uint32_t dwAllocCount;
+    ///Number of frees
+    uint32_t dwFreeCount;
+    ///Number of failed allocations
+    uint32_t dwFailCount;
+    ///Number of allocations not yet freed
+    uint32_t dwOutstanding;
+}sOcpAllocStats_d;
+
+///Routes the allocations to the given allocator, NULL restores malloc/free
+LIBRARY_EXPORTS Void OCP_SetAllocator(const sOcpAllocator_d* PpsAllocator);
+
+///Reads the allocation counters
+LIBRARY_EXPORTS Void OCP_GetAllocStats(sOcpAllocStats_d* PpsStats);
+
+///Allocates through the configured allocator and updates the counters
+LIBRARY_EXPORTS Void* OCP_Malloc(size_t wSize);
+
+///Allocates zero initialized memory through the configured allocator and updates the counters
+LIBRARY_EXPORTS Void* OCP_Calloc(size_t wBlock, size_t wBlockSize);
+
+///Frees through the configured allocator and updates the counters
+LIBRARY_EXPORTS Void OCP_Free(Void* pMemory);
+
+///Malloc function to allocate the heap memory
+#define OCP_MALLOC(size)			OCP_Malloc(size)
+
+///Malloc function to allocate the heap memory
+#define OCP_CALLOC(block,blocksize)	OCP_Calloc(block,blocksize)
+
+///To free the allocated memory
+#define OCP_FREE(node)				OCP_Free(node)
+
+#else
+
 ///Malloc function to allocate the heap memory
 #define OCP_MALLOC(size)			malloc(size)
 
@@ -43,6 +101,8 @@
 ///To free the allocated memory
 #define OCP_FREE(node)				free(node)
 
+#endif //OCP_USE_ALLOCATOR_HOOKS
+
 ///To copy the data from source to destination 
 #define OCP_MEMCPY(dst,src,size)	memcpy(dst,src,size)
 
@@ -52,6 +52,56 @@
  * DATA STRUCTURES
  *********************************************************************************************************************/
 
+/** @brief Request queued with #optiga_comms_submit. Owned by the caller until its handler is invoked. */
+typedef struct optiga_comms_request
+{
+    /// Segments of the command, gathered in order
+    const sbBlob_d* p_tx_segments;
+    /// Number of command segments
+    uint8_t tx_segment_count;
+    /// Segments receiving the response, filled in order
+    const sbBlob_d* p_rx_segments;
+    /// Number of response segments
+    uint8_t rx_segment_count;
+    /// Number of response bytes received, valid when the handler is invoked
+    uint16_t rx_length;
+    /// Completion handler, invoked with p_handler_ctx and the status of the request
+    app_event_handler_t handler;
+    /// Context passed to the completion handler
+    void* p_handler_ctx;
+    /// Time in milliseconds the request was submitted
+    uint32_t submit_time;
+    /// Time in milliseconds the request was started on the bus
+    uint32_t start_time;
+    /// Time in milliseconds the request completed
+    uint32_t complete_time;
+    /// Next request in the queue
+    struct optiga_comms_request* p_next;
+} optiga_comms_request_t;
+
+/** @brief Counters of the optiga comms request queue */
+typedef struct optiga_comms_queue_stats
+{
+    /// Requests currently queued, including the one in progress
+    uint16_t depth;
+    /// Highest depth seen
+    uint16_t max_depth;
+    /// Number of submitted requests
+    uint32_t submitted_count;
+    /// Number of completed requests, including the failed ones
+    uint32_t completed_count;
+    /// Number of requests completed with an error
+    uint32_t error_count;
+    /// Accumulated time in milliseconds the requests waited in the queue before being started
+    uint32_t total_wait_time;
+    /// Longest wait in the queue in milliseconds
+    uint32_t max_wait_time;
+    /// Accumulated time in milliseconds from submission to completion
+    uint32_t total_latency;
+    /// Longest time from submission to completion in milliseconds
+    uint32_t max_latency;
+} optiga_comms_queue_stats_t;
+
 /** @brief optiga comms structure */
 typedef struct optiga_comms
 {
@@ -63,6 +113,12 @@ typedef struct optiga_comms
     app_event_handler_t upper_layer_handler; 
     /// Optiga comms state
     uint8_t state;
+    /// Oldest queued request, in progress if the queue is running
+    optiga_comms_request_t* p_queue_head;
+    /// Latest queued request
+    optiga_comms_request_t* p_queue_tail;
+    /// Request queue counters
+    optiga_comms_queue_stats_t queue_stats;
 }optiga_comms_t;
 
 extern optiga_comms_t optiga_comms;
@@ -91,6 +147,27 @@ LIBRARY_EXPORTS host_lib_status_t optiga_comms_transceive(optiga_comms_t *p_ctx,
                                                           const uint16_t* p_data_length,
                                                           uint8_t* p_buffer, uint16_t* p_buffer_len);
 
+/**
+ * \brief   Sends the APDU gathered from segments and scatters the response over segments.
+ */
+LIBRARY_EXPORTS host_lib_status_t optiga_comms_transceive_sg(optiga_comms_t *p_ctx,
+                                                             const sbBlob_d* p_tx_segments, uint8_t tx_segment_count,
+                                                             const sbBlob_d* p_rx_segments, uint8_t rx_segment_count,
+                                                             uint16_t* p_rx_length);
+
+/**
+ * \brief   Queues a request, the requests are sent back-to-back and completed through their handlers.
+ *
+ * Submitting from a thread other than the pal_os_event context requires PAL_OS_HAS_CRITICAL_SECTION,
+ * see optiga/pal/pal_os_config.h.
+ */
+LIBRARY_EXPORTS host_lib_status_t optiga_comms_submit(optiga_comms_t *p_ctx, optiga_comms_request_t* p_request);
+
+/**
+ * \brief   Reads the counters of the request queue.
+ */
+LIBRARY_EXPORTS host_lib_status_t optiga_comms_get_queue_stats(optiga_comms_t *p_ctx, optiga_comms_queue_stats_t* p_stats);
+
 /**
  * \brief   Closes the communication channel with OPTIGA.
  */
@@ -84,6 +84,12 @@ host_lib_status_t ifx_i2c_reset(ifx_i2c_context_t *p_ctx, ifx_i2c_reset_type_t r
 host_lib_status_t ifx_i2c_transceive(ifx_i2c_context_t *p_ctx,const uint8_t* p_data, const uint16_t* p_data_length, 
                           uint8_t* p_buffer, uint16_t* p_buffer_len);
 
+/**
+ * \brief   Sends a command gathered from segments and scatters the response over segments.
+ */
+host_lib_status_t ifx_i2c_transceive_sg(ifx_i2c_context_t *p_ctx,const sbBlob_d* p_tx_segments, uint8_t tx_segment_count,
+                                        const sbBlob_d* p_rx_segments, uint8_t rx_segment_count, uint16_t* p_rx_length);
+
 /**
  * \brief   Closes the IFX I2C protocol stack for a given context.
  */
@@ -94,6 +100,11 @@ host_lib_status_t ifx_i2c_close(ifx_i2c_context_t *p_ctx);
  */
 host_lib_status_t ifx_i2c_set_slave_address(ifx_i2c_context_t *p_ctx, uint8_t slave_address, uint8_t persistent);
 
+/**
+ * \brief   Reads the learned response time profile of an APDU command.
+ */
+host_lib_status_t ifx_i2c_get_poll_stats(ifx_i2c_context_t *p_ctx, uint8_t apdu_cmd, ifx_i2c_poll_stats_t* p_stats);
+
 #ifdef __cplusplus
 }
 #endif
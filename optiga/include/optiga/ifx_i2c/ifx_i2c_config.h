@@ -60,6 +60,35 @@ extern "C" {
 #define PL_DATA_POLLING_INVERVAL_US (5000)
 /** @brief Physical Layer: guard time interval in microseconds */
 #define PL_GUARD_TIME_INTERVAL_US   (50)
+/**
+ * @brief Physical Layer: read registers with a combined write-then-read transaction (set to 0 or 1).
+ *
+ * Requires pal_i2c_write_read. The register address write and the read are issued as one repeated start
+ * transaction without the guard time in between, enable only if the slave tolerates this.
+ */
+#ifndef PL_COMBINED_REGISTER_READ
+#define PL_COMBINED_REGISTER_READ   (0)
+#endif
+/**
+ * @brief Physical Layer: adapt the status polling interval to the learned execution time of each APDU command (set to 0 or 1).
+ *
+ * The first poll is scheduled near the expected completion of the command, later polls back off exponentially
+ * from PL_ADAPTIVE_POLLING_MIN_US up to PL_DATA_POLLING_INVERVAL_US. If set to 0, the fixed PL_DATA_POLLING_INVERVAL_US is used.
+ * Enabling it adds PL_POLL_PROFILE_SIZE learned profiles to each ifx_i2c_context_t.
+ */
+#ifndef PL_ADAPTIVE_POLLING
+#define PL_ADAPTIVE_POLLING         (0)
+#endif
+/** @brief Physical Layer: shortest status polling interval in microseconds used by the adaptive polling */
+#ifndef PL_ADAPTIVE_POLLING_MIN_US
+#define PL_ADAPTIVE_POLLING_MIN_US  (250)
+#endif
+/** @brief Physical Layer: number of APDU commands for which the execution time is learned */
+#ifndef PL_POLL_PROFILE_SIZE
+#define PL_POLL_PROFILE_SIZE        (8)
+#endif
+/** @brief Physical Layer: number of execution time histogram buckets, bucket n holds times up to PL_ADAPTIVE_POLLING_MIN_US << n */
+#define PL_POLL_HISTOGRAM_SIZE      (16)
 
 /** @brief Data link layer: maximum frame size */
 #ifndef DL_MAX_FRAME_SIZE
@@ -69,8 +98,45 @@ extern "C" {
 #define DL_HEADER_SIZE              (5)
 /** @brief Data link layer: maximum number of retries in case of transmission error */
 #define DL_TRANS_REPEAT             (3)
+/**
+ * @brief Data link layer: maximum number of unacknowledged data frames (1 to 3).
+ *
+ * Values above 1 compile in the sliding window mode, which keeps a copy of each unacknowledged frame
+ * (DL_MAX_WINDOW_SIZE * DL_MAX_FRAME_SIZE bytes). The window used at runtime is set by
+ * ifx_i2c_context_t::dl_window_size and requires a slave accepting more than one outstanding frame.
+ */
+#ifndef DL_MAX_WINDOW_SIZE
+#define DL_MAX_WINDOW_SIZE          (1)
+#endif
+#if (DL_MAX_WINDOW_SIZE < 1) || (DL_MAX_WINDOW_SIZE > 3)
+#error "DL_MAX_WINDOW_SIZE must be 1 to 3, the frame number has 2 bits"
+#endif
+/**
+ * @brief Data link layer: delay in microseconds before a received data frame is acknowledged by a control frame.
+ *
+ * A data frame sent within the delay carries the acknowledgement in its ACKNR and the control frame is saved.
+ * 0 acknowledges every data frame immediately. Requires a slave accepting acknowledgements in data frames.
+ * The timer is cancelled with pal_os_event_cancel (PAL_OS_HAS_EVENT_CANCEL) when the next operation starts. With an
+ * event PAL running the callbacks on their own thread, PAL_OS_HAS_CRITICAL_SECTION is required, else the timer may
+ * start its control frame while the next operation starts a frame.
+ */
+#ifndef DL_DELAYED_ACK_US
+#define DL_DELAYED_ACK_US           (0)
+#endif
 /** @brief Data link layer: Trans timeout in milliseconds*/
 #define PL_TRANS_TIMEOUT_MS         (10)
+/** @brief Data link layer: CRC engine calculating bit by bit, no lookup table */
+#define DL_CRC_ENGINE_BITWISE       (0)
+/** @brief Data link layer: CRC engine with one 256 entry lookup table (512 bytes) */
+#define DL_CRC_ENGINE_TABLE         (1)
+/** @brief Data link layer: CRC engine processing 4 bytes per step with four lookup tables (2 kB) */
+#define DL_CRC_ENGINE_SLICE_BY_4    (2)
+/** @brief Data link layer: CRC engine processing 8 bytes per step with eight lookup tables (4 kB) */
+#define DL_CRC_ENGINE_SLICE_BY_8    (3)
+/** @brief Data link layer: CRC engine used for the frame CRC */
+#ifndef DL_CRC_ENGINE
+#define DL_CRC_ENGINE               (DL_CRC_ENGINE_TABLE)
+#endif
 
 /** @brief Transport layer: Maximum exit timeout in seconds */
 #define TL_MAX_EXIT_TIMEOUT         (6)
@@ -125,6 +191,38 @@ typedef struct ifx_i2c_context ifx_i2c_context_t;
 /** @brief Event handler function prototype */
 typedef void (*ifx_i2c_event_handler_t)(struct ifx_i2c_context* ctx, host_lib_status_t event, const uint8_t* data, uint16_t data_len);
 
+/** @brief Physical layer: learned execution time of an APDU command */
+typedef struct ifx_i2c_pl_poll_profile
+{
+    /// APDU command byte
+    uint8_t  apdu_cmd;
+    /// Number of execution time samples, 0 if the entry is unused
+    uint32_t sample_count;
+    /// Moving average of the execution time in microseconds
+    uint32_t expected_time_us;
+    /// Number of status register polls which found no response
+    uint32_t poll_count;
+    /// Execution time histogram
+    uint32_t histogram[PL_POLL_HISTOGRAM_SIZE];
+} ifx_i2c_pl_poll_profile_t;
+
+/** @brief Adaptive polling statistics of an APDU command */
+typedef struct ifx_i2c_poll_stats
+{
+    /// APDU command byte
+    uint8_t  apdu_cmd;
+    /// Number of execution time samples
+    uint32_t sample_count;
+    /// Moving average of the execution time in microseconds
+    uint32_t expected_time_us;
+    /// Median execution time in microseconds (upper bound of the histogram bucket)
+    uint32_t median_time_us;
+    /// 99th percentile execution time in microseconds (upper bound of the histogram bucket)
+    uint32_t p99_time_us;
+    /// Number of status register polls which found no response
+    uint32_t poll_count;
+} ifx_i2c_poll_stats_t;
+
 /** @brief Physical layer structure */
 typedef struct ifx_i2c_pl
 {    
@@ -140,6 +238,8 @@ typedef struct ifx_i2c_pl
     uint8_t  register_action;
     /// i2c read/i2c write
     uint8_t  i2c_cmd;
+    /// Register address sent by the combined register read
+    uint8_t  register_address;
     /// Retry counter
     uint16_t retry_counter;
     
@@ -162,6 +262,19 @@ typedef struct ifx_i2c_pl
     uint8_t   negotiate_state;
     /// Soft reset requested
     uint8_t   request_soft_reset;
+
+    // Physical Layer adaptive polling variables
+
+    /// Profile of the APDU command waiting for its response, NULL if no response is awaited
+    ifx_i2c_pl_poll_profile_t* p_poll_profile;
+    /// Start time of the response wait in milliseconds
+    uint32_t  poll_start_time;
+    /// Current status polling back off interval in microseconds, 0 before the first poll
+    uint32_t  poll_backoff_us;
+#if (PL_ADAPTIVE_POLLING == 1)
+    /// Learned execution times of APDU commands
+    ifx_i2c_pl_poll_profile_t poll_profile[PL_POLL_PROFILE_SIZE];
+#endif
 } ifx_i2c_pl_t;
 
 /** @brief Datalink layer structure */
@@ -195,6 +308,36 @@ typedef struct ifx_i2c_dl
     uint8_t* p_rx_frame_buffer;
     ///Start time of sending frame
     uint32_t frame_start_time;
+    /// Payload to be copied into the transmit buffer while calculating the CRC
+    const uint8_t* p_tx_copy_src;
+    /// Length of payload to be copied, 0 if the frame is complete in the transmit buffer
+    uint16_t tx_copy_len;
+    /// Upper layer has more frames of the packet to send
+    uint8_t tx_more_frames;
+    /// Last received data frame is not acknowledged yet
+    uint8_t ack_pending;
+    /// Data frame waits for the delayed acknowledgement to be written
+    uint8_t tx_deferred;
+#if (DL_MAX_WINDOW_SIZE > 1)
+    /// Transmit window in use, 1 for stop-and-wait
+    uint8_t window_size;
+    /// Number of unacknowledged data frames
+    uint8_t win_count;
+    /// Number of unacknowledged data frames sent since the last retransmission
+    uint8_t win_sent;
+    /// Index of the oldest unacknowledged data frame in win_buffer
+    uint8_t win_head;
+    /// Frame number of the oldest unacknowledged data frame
+    uint8_t win_base_nr;
+    /// Last data frame may stay unacknowledged, the upper layer has more frames to send
+    uint8_t win_more;
+    /// Last frame sent was a data frame
+    uint8_t tx_data_frame;
+    /// Length of the unacknowledged data frames
+    uint16_t win_frame_len[DL_MAX_WINDOW_SIZE];
+    /// Unacknowledged data frames
+    uint8_t win_buffer[DL_MAX_WINDOW_SIZE][DL_MAX_FRAME_SIZE];
+#endif
     // Upper layer Event handler
     ifx_i2c_event_handler_t upper_layer_event_handler;
 } ifx_i2c_dl_t;
@@ -206,19 +349,29 @@ typedef struct ifx_i2c_tl
     
     /// Transport layer state
     uint8_t  state;
-    /// Pointer to packet provided by user
-    uint8_t* p_actual_packet;
+    /// Segments of the packet provided by user, gathered in order
+    const sbBlob_d* p_tx_segments;
+    /// Number of segments in p_tx_segments
+    uint8_t tx_segment_count;
+    /// Segment describing a contiguous packet provided by user
+    sbBlob_d tx_segment;
     /// Total received data
     uint16_t total_recv_length;
     /// Actual length of user provided packet
     uint16_t actual_packet_length;
-    /// Offset till which data is sent from p_actual_packet
+    /// Offset till which data is sent from p_tx_segments
     uint16_t packet_offset;
     /// Maximum length of packet at transport layer
     uint16_t max_packet_length;
-    /// Pointer to user provided receive buffer
-    uint8_t* p_recv_packet_buffer;
-    /// Length of receive buffer
+    /// Segments of the user provided receive buffer, filled in order
+    const sbBlob_d* p_rx_segments;
+    /// Number of segments in p_rx_segments
+    uint8_t rx_segment_count;
+    /// Segment describing a contiguous receive buffer provided by user
+    sbBlob_d rx_segment;
+    /// Total length of the receive segments
+    uint16_t recv_packet_capacity;
+    /// Length of received packet
     uint16_t* p_recv_packet_buffer_length;
     /// Start time of the transport layer API
     uint32_t api_start_time;
@@ -232,6 +385,8 @@ typedef struct ifx_i2c_tl
     uint8_t transmission_completed;
 	/// Error event state
 	uint8_t error_event;
+    /// Command byte of the APDU in transmission
+    uint8_t apdu_cmd;
     
     /// Upper layer event handler
     ifx_i2c_event_handler_t upper_layer_event_handler;
@@ -252,6 +407,8 @@ typedef struct ifx_i2c_context
     pal_gpio_t* p_slave_reset_pin;  
     /// Pointer to pal i2c context
     pal_i2c_t* p_pal_i2c_ctx;
+    /// Data link layer transmit window (unacknowledged data frames), 0 or 1 for stop-and-wait. Limited to DL_MAX_WINDOW_SIZE
+    uint8_t dl_window_size;
      
     /// Upper layer event handler
     app_event_handler_t upper_layer_event_handler;
@@ -91,6 +91,24 @@ host_lib_status_t ifx_i2c_dl_init(ifx_i2c_context_t *p_ctx,ifx_i2c_event_handler
  */
 host_lib_status_t ifx_i2c_dl_send_frame(ifx_i2c_context_t *p_ctx,uint16_t frame_len);
 
+/**
+ * @brief Function for sending a frame with the payload copied into the transmit buffer.
+ *
+ * Same as @ref ifx_i2c_dl_send_frame, except that the last payload_len bytes of the frame
+ * are copied from p_payload while the frame CRC is calculated. The preceding bytes of the
+ * frame must already be in the transmit buffer.
+ *
+ * @param[in,out] p_ctx     Pointer to ifx i2c context.
+ * @param[in] frame_len     Frame length.
+ * @param[in] p_payload     Payload to be copied. Must remain valid until the frame is sent.
+ * @param[in] payload_len   Payload length.
+ *
+ * @retval  IFX_I2C_STACK_SUCCESS If function was successful.
+ * @retval  IFX_I2C_STACK_ERROR If the module is busy.
+ */
+host_lib_status_t ifx_i2c_dl_send_frame_copy(ifx_i2c_context_t *p_ctx,uint16_t frame_len,
+                                             const uint8_t* p_payload, uint16_t payload_len);
+
 /**
  * @brief Function for receiving a frame.
  *
@@ -114,6 +114,18 @@ host_lib_status_t ifx_i2c_pl_receive_frame(ifx_i2c_context_t *p_ctx);
  * @retval  IFX_I2C_STACK_ERROR   If setting slave address fails.
  */
 host_lib_status_t ifx_i2c_pl_write_slave_address(ifx_i2c_context_t *p_ctx, uint8_t slave_address, uint8_t storage_type);
+
+/**
+ * @brief Function for reading the learned response time profile of an APDU command.
+ *
+ * @param[in]  p_ctx        Pointer to ifx i2c context.
+ * @param[in]  apdu_cmd     APDU command byte.
+ * @param[out] p_stats      Pointer to the statistics.
+ *
+ * @retval  IFX_I2C_STACK_SUCCESS If function was successful.
+ * @retval  IFX_I2C_STACK_ERROR   If no response time was recorded for the command.
+ */
+host_lib_status_t ifx_i2c_pl_get_poll_stats(ifx_i2c_context_t *p_ctx, uint8_t apdu_cmd, ifx_i2c_poll_stats_t* p_stats);
 /**
  * @}
  **/
@@ -89,6 +89,28 @@ host_lib_status_t ifx_i2c_tl_init(ifx_i2c_context_t *p_ctx,ifx_i2c_event_handler
 host_lib_status_t ifx_i2c_tl_transceive(ifx_i2c_context_t *p_ctx,uint8_t* p_packet, uint16_t packet_len,
                                uint8_t* p_recv_packet, uint16_t* recv_packet_len);
 
+/**
+ * @brief Function to transmit a packet gathered from segments and receive a packet into segments.
+ *
+ * Asynchronous function, same as @ref ifx_i2c_tl_transceive except that the packet is the concatenation
+ * of the transmit segments and the received packet is scattered over the receive segments in order.
+ * Fragments are gathered directly from the segments into the data link layer frames.
+ * The segment arrays and the memory they refer to must remain valid until the transceive completes.
+ *
+ * @param[in,out] p_ctx     Pointer to ifx i2c context.
+ * @param[in] p_tx_segments        Segments of the packet, first segment must not be empty.
+ * @param[in] tx_segment_count     Number of transmit segments.
+ * @param[in] p_rx_segments        Segments to receive the packet.
+ * @param[in] rx_segment_count     Number of receive segments.
+ * @param[out] recv_packet_len     Length of the received packet.
+ *
+ * @retval  IFX_I2C_STACK_SUCCESS If function was successful.
+ * @retval  IFX_I2C_STACK_ERROR If the module is busy or the segments are invalid.
+ */
+host_lib_status_t ifx_i2c_tl_transceive_sg(ifx_i2c_context_t *p_ctx,const sbBlob_d* p_tx_segments, uint8_t tx_segment_count,
+                                           const sbBlob_d* p_rx_segments, uint8_t rx_segment_count,
+                                           uint16_t* recv_packet_len);
+
 /**
  * @}
  **/
@@ -37,6 +37,9 @@ extern "C" {
 
 #include "optiga/common/Datatypes.h"
 #include "optiga/cmd/CommandLib.h"
+#ifdef OPTIGA_CRYPT_DRBG
+#include "mbedtls/ctr_drbg.h"
+#endif
 
 /**
  * OPTIGA crypt module return values
@@ -164,6 +167,34 @@ typedef struct hash_data_in_optiga
 	uint16_t length;
 } hash_data_in_optiga_t;
 
+/**
+ * \brief Source of the data hashed by #optiga_crypt_hash_update_stream.
+ *
+ * Fills p_buffer with up to *p_length bytes and updates *p_length with the number of bytes provided.<br>
+ * Less bytes than requested are only provided at the end of the data, 0 bytes indicate the end of the data.<br>
+ * The source is invoked while OPTIGA processes the previous chunk and must not call any OPTIGA API.
+ */
+typedef optiga_lib_status_t (*optiga_crypt_hash_source_t)(void * p_ctx, uint8_t * p_buffer, uint16_t * p_length);
+
+#ifdef OPTIGA_CRYPT_HASH_RESIDENT_CONTEXT
+/**
+ * \brief Statistics of the hash commands sent to OPTIGA.
+ */
+typedef struct optiga_crypt_hash_stats
+{
+    ///Number of hash updates
+    uint32_t update_count;
+    ///Number of hash contexts imported to OPTIGA
+    uint32_t context_import_count;
+    ///Number of hash contexts exported from OPTIGA
+    uint32_t context_export_count;
+    ///Number of bytes sent to OPTIGA with hash commands
+    uint32_t bytes_sent;
+    ///Number of bytes received from OPTIGA for hash commands
+    uint32_t bytes_received;
+} optiga_crypt_hash_stats_t;
+#endif
+
 /**
  * \brief To specifiy the Public Key details (key, size and algorithm)
  */
@@ -186,6 +217,155 @@ typedef struct key_from_opitga
     uint16_t key_oid;
 } optiga_shared_secret_t;
 
+/**
+ * \brief Descriptor of one signature of #optiga_crypt_ecdsa_sign_batch.
+ */
+typedef struct optiga_crypt_sign_item
+{
+    /// Digest on which the signature is generated
+    uint8_t * digest;
+    /// Length of the digest
+    uint8_t digest_length;
+    /// Buffer receiving the signature
+    uint8_t * signature;
+    /// Size of the signature buffer, updated with the length of the signature (0 on error)
+    uint16_t signature_length;
+    /// Result of the signing, same values as returned by #optiga_crypt_ecdsa_sign
+    optiga_lib_status_t status;
+} optiga_crypt_sign_item_t;
+
+/**
+ * \brief Handler invoked when a signature queued with #optiga_crypt_ecdsa_sign_submit completes.
+ *
+ * The handler is invoked from the context completing the command, usually the pal_os_event callback,
+ * while the lock is still held. It must not call the blocking APIs. It may queue further signatures with
+ * #optiga_crypt_ecdsa_sign_submit, which then join the running queue without waiting.
+ */
+typedef void (*optiga_crypt_sign_handler_t)(void * p_ctx, optiga_lib_status_t status, uint16_t signature_length);
+
+/**
+ * \brief Signature request of #optiga_crypt_ecdsa_sign_submit, owned by the library until its handler is invoked.
+ */
+typedef struct optiga_crypt_sign_request
+{
+    /// Queued command, used by the library
+    sCmdLibSignRequest_d cmd_request;
+    /// Signature buffer, used by the library
+    sbBlob_d signature;
+    /// Completion handler
+    optiga_crypt_sign_handler_t handler;
+    /// Context passed to the handler
+    void * p_ctx;
+} optiga_crypt_sign_request_t;
+
+#ifdef OPTIGA_CRYPT_RANDOM_POOL_SIZE
+/**
+ * \brief Handler invoked when the random pool falls below its low-water mark.
+ *
+ * The handler is invoked from the thread consuming random data and must not block, it is expected to wake up
+ * the task calling #optiga_crypt_random_pool_refill.
+ */
+typedef void (*optiga_crypt_random_pool_refill_request_t)(void * p_ctx);
+
+/**
+ * \brief Statistics of the random pool.
+ */
+typedef struct optiga_crypt_random_stats
+{
+    ///Number of random requests served by the pool
+    uint32_t request_count;
+    ///Number of requests which could not be served from the pool only
+    uint32_t pool_miss_count;
+    ///Accumulated time in milliseconds to serve the requests
+    uint32_t total_latency;
+    ///Longest time in milliseconds to serve a request
+    uint32_t max_latency;
+    ///Number of random reads from OPTIGA
+    uint32_t refill_count;
+    ///Number of random bytes read from OPTIGA
+    uint32_t refill_bytes;
+    ///Number of random reads from OPTIGA which failed the health tests
+    uint32_t health_failure_count;
+    ///Number of bytes currently in the pool
+    uint16_t pool_level;
+} optiga_crypt_random_stats_t;
+#endif
+
+#ifdef OPTIGA_CRYPT_DRBG
+/// Default number of bytes generated by a host DRBG before it is reseeded from OPTIGA
+#ifndef OPTIGA_CRYPT_DRBG_RESEED_BYTES
+#define OPTIGA_CRYPT_DRBG_RESEED_BYTES          (0x100000)
+#endif
+
+/// Default time in milliseconds after which a host DRBG is reseeded from OPTIGA
+#ifndef OPTIGA_CRYPT_DRBG_RESEED_INTERVAL_MS
+#define OPTIGA_CRYPT_DRBG_RESEED_INTERVAL_MS    (60000)
+#endif
+
+/**
+ * \brief Host CTR_DRBG seeded from the OPTIGA TRNG.
+ */
+typedef struct optiga_crypt_drbg
+{
+    ///DRBG state
+    mbedtls_ctr_drbg_context ctr_drbg;
+    ///Number of bytes generated after which the DRBG is reseeded
+    uint32_t reseed_bytes;
+    ///Time in milliseconds after which the DRBG is reseeded, 0 if the DRBG is not reseeded by time
+    uint32_t reseed_interval;
+    ///Number of bytes generated since the last reseed
+    uint32_t generated_since_reseed;
+    ///Time of the last reseed in milliseconds
+    uint32_t reseed_time;
+    ///Number of seeds read from OPTIGA
+    uint32_t reseed_count;
+} optiga_crypt_drbg_t;
+#endif
+
+#ifdef OPTIGA_CRYPT_ECDH_POOL_SLOTS
+/**
+ * \brief Statistics of the ECDH key pair pool.
+ */
+typedef struct optiga_crypt_ecdh_pool_stats
+{
+    ///Number of key pairs handed out by #optiga_crypt_ecdh_pool_acquire
+    uint32_t acquire_count;
+    ///Number of key pairs which were not prepared and generated on request
+    uint32_t pool_miss_count;
+    ///Number of key pair generations
+    uint32_t keygen_count;
+    ///Number of key pairs taken back as they were not given back within OPTIGA_CRYPT_ECDH_POOL_LEASE_TIME
+    uint32_t reclaim_count;
+    ///Accumulated time in milliseconds to hand out the key pairs
+    uint32_t total_latency;
+    ///Longest time in milliseconds to hand out a key pair
+    uint32_t max_latency;
+    ///Number of key pairs currently prepared
+    uint8_t ready_count;
+} optiga_crypt_ecdh_pool_stats_t;
+#endif
+
+/**
+ * \brief Statistics of #optiga_crypt_tls12_key_schedule, times in milliseconds.
+ */
+typedef struct optiga_crypt_tls12_key_schedule_stats
+{
+    ///Number of key schedules
+    uint32_t schedule_count;
+    ///Number of key schedules which failed
+    uint32_t failure_count;
+    ///Accumulated time of the key schedules
+    uint32_t total_latency;
+    ///Longest time of a key schedule
+    uint32_t max_latency;
+    ///Accumulated time of the shared secret calculations
+    uint32_t shared_secret_latency;
+    ///Accumulated time of the master secret derivations
+    uint32_t master_secret_latency;
+    ///Accumulated time of the key expansions
+    uint32_t key_expansion_latency;
+} optiga_crypt_tls12_key_schedule_stats_t;
+
 /**
  * @brief Generates a random number.
  *
@@ -203,6 +383,8 @@ typedef struct key_from_opitga
  * - Error codes from lower layers will be returned as it is.<br>
  * - The maximum value of the <b>random_data_length</b> parameter is size of buffer <b>random_data</b>.
  *   In case the value is greater than buffer size, memory corruption can occur.<br>
+ * - With OPTIGA_CRYPT_RANDOM_POOL_SIZE defined, the requests for OPTIGA_CRYPT_RANDOM_POOL_RNG_TYPE (TRNG by default)
+ *   are served from the random pool and any length is supported. See #optiga_crypt_random_pool_refill.<br>
  *
  * \param[in]      rng_type               Type of random data generator.
  *                                        - The input must be from #optiga_rng_type.
@@ -221,6 +403,121 @@ LIBRARY_EXPORTS optiga_lib_status_t optiga_crypt_random(optiga_rng_types_t rng_t
                                                         uint8_t * random_data,
                                                         uint16_t random_data_length);
 
+#ifdef OPTIGA_CRYPT_DRBG
+/**
+ * @brief Instantiates a host DRBG seeded from OPTIGA.
+ *
+ * With OPTIGA_CRYPT_DRBG defined, the random data for bulk usage (nonces, padding, IVs) can be generated with the
+ * mbedtls CTR_DRBG on the host. Only the seeds are read from the OPTIGA TRNG, the generation runs at host speed.<br>
+ *
+ *<b>Pre Conditions:</b>
+ * - The application on OPTIGA must be opened using #optiga_util_open_application before using this API.<br>
+ * - The mbedtls library must be built with MBEDTLS_CTR_DRBG_C.<br>
+ *
+ *<b>API Details:</b><br>
+ * - Seeds the DRBG with entropy from #optiga_crypt_random with OPTIGA_RNG_TYPE_TRNG.<br>
+ * - The DRBG is reseeded after OPTIGA_CRYPT_DRBG_RESEED_BYTES bytes or OPTIGA_CRYPT_DRBG_RESEED_INTERVAL_MS milliseconds,
+ *   see #optiga_crypt_drbg_set_reseed_budget.<br>
+ *
+ *<b>Notes:</b><br>
+ *  - An instance is not locked and must be used by one thread only, use one instance per thread.<br>
+ *  - The instance must be freed with #optiga_crypt_drbg_free.<br>
+ *
+ * \param[in,out]  drbg                   Pointer to the DRBG instance, must not be NULL
+ * \param[in]      personalization        Data to personalize the instance, e.g. a thread identifier, can be NULL
+ * \param[in]      personalization_length Length of the personalization data
+ *
+ * \retval  #OPTIGA_LIB_SUCCESS                             Successful invocation
+ * \retval  #OPTIGA_LIB_ERROR                               Reading the seed from OPTIGA failed
+ */
+LIBRARY_EXPORTS optiga_lib_status_t optiga_crypt_drbg_init(optiga_crypt_drbg_t * drbg,
+                                                           const uint8_t * personalization,
+                                                           uint16_t personalization_length);
+
+/**
+ * @brief Sets the budget after which a host DRBG is reseeded from OPTIGA.
+ *
+ * \param[in,out]  drbg                   Pointer to the DRBG instance, must not be NULL
+ * \param[in]      reseed_bytes           Number of bytes generated after which the DRBG is reseeded,
+ *                                        0 to reseed for every 1024 bytes
+ * \param[in]      reseed_interval        Time in milliseconds after which the DRBG is reseeded, 0 to not reseed by time
+ */
+LIBRARY_EXPORTS void optiga_crypt_drbg_set_reseed_budget(optiga_crypt_drbg_t * drbg,
+                                                         uint32_t reseed_bytes,
+                                                         uint32_t reseed_interval);
+
+/**
+ * @brief Generates random data with a host DRBG.
+ *
+ * The DRBG is reseeded from OPTIGA first if its budget is used up.<br>
+ *
+ * \param[in,out]  drbg                   Pointer to the DRBG instance, must not be NULL
+ * \param[out]     random_data            Pointer to the buffer into which random data is stored, must not be NULL
+ * \param[in]      random_data_length     Length of random data to be generated
+ *
+ * \retval  #OPTIGA_LIB_SUCCESS                             Successful invocation
+ * \retval  #OPTIGA_LIB_ERROR                               Reseeding from OPTIGA or generating failed
+ */
+LIBRARY_EXPORTS optiga_lib_status_t optiga_crypt_drbg_generate(optiga_crypt_drbg_t * drbg,
+                                                               uint8_t * random_data,
+                                                               uint32_t random_data_length);
+
+/**
+ * @brief Frees a host DRBG instance and clears its state.
+ *
+ * \param[in,out]  drbg                   Pointer to the DRBG instance, must not be NULL
+ */
+LIBRARY_EXPORTS void optiga_crypt_drbg_free(optiga_crypt_drbg_t * drbg);
+#endif
+
+#ifdef OPTIGA_CRYPT_RANDOM_POOL_SIZE
+/**
+ * @brief Fills the random pool.
+ *
+ * Reads random data from OPTIGA in batches of OPTIGA_CRYPT_RANDOM_POOL_BATCH bytes until the pool is full.<br>
+ * With OPTIGA_CRYPT_RANDOM_POOL_SIZE defined, #optiga_crypt_random serves the requests from a pool of random data,
+ * so that the caller does not wait for OPTIGA. The pool is expected to be filled by a background task calling this API
+ * whenever the handler set with #optiga_crypt_random_pool_set_refill_request is invoked.<br>
+ *
+ *<b>Pre Conditions:</b>
+ * - The application on OPTIGA must be opened using #optiga_util_open_application before using this API.<br>
+ *
+ *<b>API Details:</b><br>
+ * - Every batch read from OPTIGA is checked with the repetition count and adaptive proportion tests of NIST SP 800-90B.
+ *   A batch failing the tests is discarded.<br>
+ *
+ *<b>Notes:</b><br>
+ *  - The pool is below the low-water mark OPTIGA_CRYPT_RANDOM_POOL_LOW_WATER (half of the pool by default) when
+ *    the refill is requested.<br>
+ *  - Requests larger than the pool and the bytes missing in the pool are read from OPTIGA by the requesting thread.
+ *    The rest of the last batch is kept in the pool, so the pool is also filled without a background task.<br>
+ *  - Random bytes are provided only once and cleared from the pool when taken.<br>
+ *  - The pool requires PAL_OS_HAS_CRITICAL_SECTION, the PAL must provide the critical section.<br>
+ *
+ * \retval  #OPTIGA_LIB_SUCCESS                             The pool is full
+ * \retval  #OPTIGA_LIB_ERROR                               Reading from OPTIGA failed or the data failed the health tests
+ */
+LIBRARY_EXPORTS optiga_lib_status_t optiga_crypt_random_pool_refill(void);
+
+/**
+ * @brief Sets the handler invoked when the random pool falls below its low-water mark.
+ *
+ * The handler is invoked once until the pool is refilled above the low-water mark.<br>
+ *
+ * \param[in]   handler                   Handler to invoke, NULL to remove the handler
+ * \param[in]   p_ctx                     Context passed to the handler
+ */
+LIBRARY_EXPORTS void optiga_crypt_random_pool_set_refill_request(optiga_crypt_random_pool_refill_request_t handler,
+                                                                 void * p_ctx);
+
+/**
+ * @brief Gets the statistics of the random pool.
+ *
+ * \param[out]  p_stats                   Pointer to #optiga_crypt_random_stats_t to be filled, must not be NULL
+ */
+LIBRARY_EXPORTS void optiga_crypt_random_get_stats(optiga_crypt_random_stats_t * p_stats);
+#endif
+
 
 
  /**
@@ -289,6 +586,45 @@ LIBRARY_EXPORTS optiga_lib_status_t optiga_crypt_hash_update(optiga_hash_context
                                                              uint8_t source_of_data_to_hash,
                                                              void * data_to_hash);
 
+ /**
+ *
+ * @brief Updates a hash context with the data provided by a source.
+ *
+ * Updates hashing for the data read from the source until its end, then exports the updated hash context.<br>
+ * Use this API for inputs which are not available in host memory at once, e.g. files read from a descriptor.
+ * Inputs mapped to host memory (e.g. a file mapped with mmap) can be hashed without any copy with #optiga_crypt_hash_update.
+ *
+ *
+ *<b>Pre Conditions:</b>
+ * - The application on OPTIGA must be opened using #optiga_util_open_application before using this API.<br>
+ * - #optiga_hash_context_t from #optiga_crypt_hash_start or #optiga_crypt_hash_update must be available.
+ *
+ *<b>API Details:</b><br>
+ * - Imports the hash context with the first chunk and exports it with the last chunk.<br>
+ * - The source fills the next chunk while OPTIGA hashes the current one.<br>
+ * - OPTIGA is not available for other requests until the end of the data.<br>
+ * - Takes three chunk buffers and the command buffer from the CommandLib APDU buffer pool. If CMDLIB_APDU_POOL_COUNT
+ *   is lower than 4, or other streams hold pool buffers, the missing buffers are allocated with OCP_MALLOC.<br>
+ *
+ *<b>Notes:</b><br>
+ *  - Error codes from lower layer will be returned as it is.<br>
+ *  - An error returned by the source is returned as it is.<br>
+ *  - The hash context is unchanged if an error occurs, except if it is kept active in OPTIGA (see #optiga_crypt_hash_release).<br>
+ *  - Three chunk buffers of the maximum communication buffer size are used.<br>
+ *
+ *<br>
+ * \param[in]   hash_ctx                  Pointer to #optiga_hash_context_t containing hash context from OPTIGA, must not be NULL
+ * \param[in]   source                    Source of the data for hashing, must not be NULL
+ * \param[in]   p_ctx                     Context passed to the source
+ *
+ * \retval  #OPTIGA_LIB_SUCCESS                             Successful invocation
+ * \retval  #OPTIGA_LIB_ERROR                               Wrong Input arguments provided or no memory available
+ * \retval  #OPTIGA_DEVICE_ERROR                            Command execution failure in OPTIGA and the LSB indicates the error code.(Refer Solution Reference Manual)
+ */
+LIBRARY_EXPORTS optiga_lib_status_t optiga_crypt_hash_update_stream(optiga_hash_context_t * hash_ctx,
+                                                                    optiga_crypt_hash_source_t source,
+                                                                    void * p_ctx);
+
  /**
  *
  * @brief Finalizes and exports the hash output.
@@ -321,6 +657,51 @@ LIBRARY_EXPORTS optiga_lib_status_t optiga_crypt_hash_update(optiga_hash_context
 LIBRARY_EXPORTS optiga_lib_status_t optiga_crypt_hash_finalize(optiga_hash_context_t * hash_ctx,
                                                                uint8_t * hash_output);
 
+#ifdef OPTIGA_CRYPT_HASH_RESIDENT_CONTEXT
+/**
+ *
+ * @brief Releases a hash context kept active in OPTIGA.
+ *
+ * With OPTIGA_CRYPT_HASH_RESIDENT_CONTEXT defined, the hash context is kept active in OPTIGA after
+ * #optiga_crypt_hash_start, #optiga_crypt_hash_update and #optiga_crypt_hash_update_stream instead of being
+ * exported to the host. It is neither imported nor exported by the next update or finalization of the same context,
+ * which saves the transfer of the context for every update.<br>
+ * Only one context is kept active. It is exported to a slot of the library when another context is used,
+ * the buffer of the caller is only written by #optiga_crypt_hash_release.<br>
+ * A context takes one of OPTIGA_CRYPT_HASH_CONTEXT_SLOTS slots (default 2) from its start until it is finalized
+ * or released.<br>
+ *
+ *<b>Pre Conditions:</b>
+ * - The application on OPTIGA must be opened using #optiga_util_open_application before using this API.<br>
+ *
+ *<b>API Details:</b><br>
+ * - Exports the hash context to its buffer if the context is kept active in OPTIGA or held in a slot, and frees the slot.<br>
+ *
+ *<b>Notes:</b><br>
+ *  - A context which is not finalized must be released on every exit path, also after an error, before it is
+ *    freed or reused. Otherwise its slot stays taken.<br>
+ *  - The buffer of a context which is not released is not valid, it is left as it is.<br>
+ *  - #optiga_crypt_hash_start, #optiga_crypt_hash_update, #optiga_crypt_hash_update_stream and
+ *    #optiga_crypt_hash_finalize return #OPTIGA_CRYPT_ERROR_MEMORY_INSUFFICIENT if all slots are taken.<br>
+ *  - The context is invalid after an error in an update, in the release or in the export of the context.<br>
+ *  - The context is discarded by #optiga_util_open_application.<br>
+ *
+ *<br>
+ * \param[in]   hash_ctx                  Pointer to #optiga_hash_context_t, must not be NULL
+ *
+ * \retval  #OPTIGA_LIB_SUCCESS                             Successful invocation
+ * \retval  #OPTIGA_LIB_ERROR                               The context could not be exported or was lost
+ */
+LIBRARY_EXPORTS optiga_lib_status_t optiga_crypt_hash_release(optiga_hash_context_t * hash_ctx);
+
+/**
+ * @brief Gets the statistics of the hash commands sent to OPTIGA.
+ *
+ * \param[out]  p_stats                   Pointer to #optiga_crypt_hash_stats_t to be filled, must not be NULL
+ */
+LIBRARY_EXPORTS void optiga_crypt_hash_get_stats(optiga_crypt_hash_stats_t * p_stats);
+#endif
+
 
 
 /**
@@ -406,6 +787,87 @@ LIBRARY_EXPORTS optiga_lib_status_t optiga_crypt_ecdsa_sign(uint8_t * digest,
                                                             uint8_t * signature,
                                                             uint16_t * signature_length);
 
+/**
+ *
+ * @brief Generates signatures for several digests with the same key.
+ *
+ * Generates the signatures described by the items back-to-back using the private key stored in OPTIGA.<br>
+ *
+ *<b>Pre Conditions:</b>
+ * - The application on OPTIGA must be opened using #optiga_util_open_application before using this API.<br>
+ *
+ *<b>API Details:</b>
+ * - Holds the lock for the complete batch and signs the digests in the given order, each like #optiga_crypt_ecdsa_sign.<br>
+ * - A failing signature does not stop the batch, the result of each signature is returned in its <b>status</b> field.<br>
+ * - If raw_component_length is 0, the signatures are returned as from #optiga_crypt_ecdsa_sign, 
+ *   with the DER encoding formatting for R and S components.<br>
+ * - Else the signatures are returned as R || S, each component zero padded to raw_component_length bytes.<br>
+ *<br>
+ *
+ *<b>Notes:</b>
+ * - The <b>signature_length</b> field of an item must not exceed the size of its buffer.<br>
+ * - The other users of OPTIGA are blocked until the batch completes.<br>
+ *
+ * \param[in,out]  p_items              Valid pointer to the array of signature descriptors
+ * \param[in]      item_count           Number of signature descriptors
+ * \param[in]      private_key          Private key OID to generate the signatures
+ * \param[in]      raw_component_length 0 for DER encoded signatures, else the length of the R and S components
+ *                                      (32 for NIST P-256, 48 for NIST P-384)
+ *
+ * \retval  #OPTIGA_LIB_SUCCESS                             All the signatures are successful
+ * \retval  #OPTIGA_LIB_ERROR                               Wrong Input arguments provided or at least one signature failed,
+ *                                                         see the status of the items
+ */
+LIBRARY_EXPORTS optiga_lib_status_t optiga_crypt_ecdsa_sign_batch(optiga_crypt_sign_item_t * p_items,
+                                                                  uint16_t item_count,
+                                                                  optiga_key_id_t private_key,
+                                                                  uint8_t raw_component_length);
+
+/**
+ *
+ * @brief Queues the generation of a signature and returns without waiting for the signature.
+ *
+ * Generates the signature like #optiga_crypt_ecdsa_sign, the result is passed to the handler.<br>
+ *
+ *<b>Pre Conditions:</b>
+ * - The application on OPTIGA must be opened using #optiga_util_open_application before using this API.<br>
+ *
+ *<b>API Details:</b>
+ * - The digest is copied to the request, the request is queued with #optiga_comms_submit.<br>
+ * - The lock is acquired with the first queued request and released when the last one completes,
+ *   the queued signatures are sent back-to-back and the other APIs wait for them.<br>
+ * - The handler is invoked with p_ctx, the status and the length of the DER encoded signature.<br>
+ *<br>
+ *
+ *<b>Notes:</b>
+ * - The request and the signature buffer must stay valid until the handler is invoked.<br>
+ * - If no request is in flight, the call waits for the lock like the blocking APIs, e.g. while another API
+ *   runs a command. Called from the handler of a request, it never waits.<br>
+ * - Error codes from lower layer are passed to the handler as they are. The error code of a device error is read
+ *   after the requests already queued, the handler of the failed request is invoked then.<br>
+ *
+ * \param[in,out]  p_request              Request to queue, must not be NULL
+ * \param[in]      digest                 Digest on which the signature is generated, up to 64 bytes
+ * \param[in]      digest_length          Length of the digest
+ * \param[in]      private_key            Private key OID to generate the signature
+ * \param[in,out]  signature              Buffer receiving the signature
+ * \param[in]      signature_length       Size of the signature buffer
+ * \param[in]      handler                Handler invoked when the signature completes, must not be NULL
+ * \param[in]      p_ctx                  Context passed to the handler
+ *
+ * \retval  #OPTIGA_LIB_SUCCESS                             The request is queued, the handler will be invoked
+ * \retval  #OPTIGA_LIB_ERROR                               Wrong Input arguments provided or the request was not queued,
+ *                                                         the handler is not invoked
+ */
+LIBRARY_EXPORTS optiga_lib_status_t optiga_crypt_ecdsa_sign_submit(optiga_crypt_sign_request_t * p_request,
+                                                                   uint8_t * digest,
+                                                                   uint8_t digest_length,
+                                                                   optiga_key_id_t private_key,
+                                                                   uint8_t * signature,
+                                                                   uint16_t signature_length,
+                                                                   optiga_crypt_sign_handler_t handler,
+                                                                   void * p_ctx);
+
 /**
  *
  * @brief Verifies the signature over the given digest.
@@ -485,6 +947,81 @@ LIBRARY_EXPORTS optiga_lib_status_t optiga_crypt_ecdh(optiga_key_id_t private_ke
                                                       bool_t export_to_host,
                                                       uint8_t * shared_secret);
 
+#ifdef OPTIGA_CRYPT_ECDH_POOL_SLOTS
+/**
+ * @brief Prepares ephemeral key pairs in the ECDH pool.
+ *
+ * With OPTIGA_CRYPT_ECDH_POOL_SLOTS defined (1 - 4), the session contexts starting from #OPTIGA_SESSION_ID_E100
+ * hold ephemeral key pairs for key agreement. This API generates key pairs into the free slots during idle time,
+ * so that #optiga_crypt_ecdh_pool_acquire hands out a public key without waiting for the generation.<br>
+ *
+ *<b>Pre Conditions:</b>
+ * - The application on OPTIGA must be opened using #optiga_util_open_application before using this API.<br>
+ *
+ *<b>API Details:</b><br>
+ * - Generates key pairs until slot_count slots hold a key pair for the curve or no slot is free.<br>
+ * - The lock is released after each generation.<br>
+ *
+ *<b>Notes:</b><br>
+ *  - The session contexts are volatile, so the pool does not write the key store.<br>
+ *  - The session contexts #OPTIGA_SESSION_ID_E100 to #OPTIGA_SESSION_ID_E100 + OPTIGA_CRYPT_ECDH_POOL_SLOTS - 1 are
+ *    reserved for the pool and must not be used by the application otherwise, also not as session_id of
+ *    #optiga_crypt_tls12_key_schedule unless it is the private key taken from the pool.<br>
+ *  - The session contexts are cleared when the application on OPTIGA is opened again, the slots must then be emptied
+ *    with #optiga_crypt_ecdh_pool_release.<br>
+ *
+ * \param[in]   curve_id                  Curve of the key pairs, from #optiga_ecc_curve_t
+ * \param[in]   slot_count                Number of key pairs to keep prepared for the curve
+ *
+ * \retval  #OPTIGA_LIB_SUCCESS                             The key pairs are prepared or no slot is free
+ * \retval  #OPTIGA_LIB_ERROR                               A key pair generation failed
+ */
+LIBRARY_EXPORTS optiga_lib_status_t optiga_crypt_ecdh_pool_fill(optiga_ecc_curve_t curve_id, uint8_t slot_count);
+
+/**
+ * @brief Takes an ephemeral key pair from the ECDH pool.
+ *
+ * Hands out a prepared key pair for the curve. If none is prepared, the key pair is generated on demand into a free
+ * slot, else into a slot prepared for the other curve, else into a slot not given back within
+ * OPTIGA_CRYPT_ECDH_POOL_LEASE_TIME milliseconds (60000 by default). If all slots are in use, the key pair is generated
+ * into #OPTIGA_KEY_STORE_ID_E0F3.<br>
+ * The private key is used with #optiga_crypt_ecdh and the slot is given back with #optiga_crypt_ecdh_pool_release.<br>
+ *
+ *<b>Notes:</b><br>
+ *  - A key pair must be used and given back within the lease time, later its slot may hold another key pair.<br>
+ *  - #OPTIGA_KEY_STORE_ID_E0F3 is not protected against concurrent requests, like without the pool.<br>
+ *
+ * \param[in]      curve_id               Curve of the key pair, from #optiga_ecc_curve_t
+ * \param[out]     private_key            Session ID holding the private key, or #OPTIGA_KEY_STORE_ID_E0F3
+ * \param[in,out]  public_key             Buffer receiving the public key, in the format of #optiga_crypt_ecc_generate_keypair
+ * \param[in,out]  public_key_length      Size of the public key buffer, updated with the length of the public key
+ *
+ * \retval  #OPTIGA_LIB_SUCCESS                             Successful invocation
+ * \retval  #OPTIGA_LIB_ERROR                               Wrong Input arguments provided or the generation failed
+ */
+LIBRARY_EXPORTS optiga_lib_status_t optiga_crypt_ecdh_pool_acquire(optiga_ecc_curve_t curve_id,
+                                                                   optiga_key_id_t * private_key,
+                                                                   uint8_t * public_key,
+                                                                   uint16_t * public_key_length);
+
+/**
+ * @brief Gives a slot back to the ECDH pool.
+ *
+ * \param[in]   private_key               Session ID from #optiga_crypt_ecdh_pool_acquire, #OPTIGA_KEY_STORE_ID_E0F3 is ignored
+ *
+ * \retval  #OPTIGA_LIB_SUCCESS                             Successful invocation
+ * \retval  #OPTIGA_LIB_ERROR                               The session ID is not a slot of the pool
+ */
+LIBRARY_EXPORTS optiga_lib_status_t optiga_crypt_ecdh_pool_release(optiga_key_id_t private_key);
+
+/**
+ * @brief Gets the statistics of the ECDH pool.
+ *
+ * \param[out]  p_stats                   Pointer to #optiga_crypt_ecdh_pool_stats_t to be filled, must not be NULL
+ */
+LIBRARY_EXPORTS void optiga_crypt_ecdh_pool_get_stats(optiga_crypt_ecdh_pool_stats_t * p_stats);
+#endif
+
 /**
  * @brief Derives a key.
  *
@@ -532,6 +1069,58 @@ LIBRARY_EXPORTS optiga_lib_status_t optiga_crypt_tls_prf_sha256(uint16_t secret,
                                                                 bool_t export_to_host,
                                                                 uint8_t * derived_key);
 
+/**
+ * @brief Runs the TLS 1.2 key schedule of an ECDHE handshake.
+ *
+ * Calculates the premaster secret, derives the master secret and expands it to the key block,
+ * keeping the premaster and master secrets in OPTIGA.<br>
+ *
+ *<b>Pre Conditions:</b>
+ * - The application on OPTIGA must be opened using #optiga_util_open_application.<br>
+ * - The ephemeral private key must be available in OPTIGA.<br>
+ *
+ *<b>API Details:</b>
+ * - Holds the lock for the three commands, so no other command runs in between.<br>
+ * - Calculates the shared secret like #optiga_crypt_ecdh, stored in session_id.<br>
+ * - Derives the master secret with the label "master secret" and ClientHello.random + ServerHello.random,
+ *   stored in session_id.<br>
+ * - Derives the key block with the label "key expansion" and ServerHello.random + ClientHello.random,
+ *   exported to the host.<br>
+ *<br>
+ *
+ *<b>Notes:</b>
+ * - The master secret stays in session_id for the Finished messages, see #optiga_crypt_tls_prf_sha256.<br>
+ * - private_key may be session_id, the private key is then overwritten by the premaster secret.<br>
+ * - With OPTIGA_CRYPT_ECDH_POOL_SLOTS defined, the session contexts of the ECDH pool are reserved. session_id may only
+ *   be one of them if it is private_key taken with #optiga_crypt_ecdh_pool_acquire, see #optiga_crypt_ecdh_pool_fill.<br>
+ * - The time spent in each command is accumulated in the statistics, see #optiga_crypt_tls12_key_schedule_get_stats.<br>
+ *
+ * \param[in]      private_key            Object ID of the ephemeral private key stored in OPTIGA
+ * \param[in]      public_key             Pointer to the public key of the peer, must not be NULL
+ * \param[in]      session_id             Session context receiving the premaster and master secrets, not reserved by the ECDH pool
+ * \param[in]      client_random          ClientHello.random, 32 bytes
+ * \param[in]      server_random          ServerHello.random, 32 bytes
+ * \param[in,out]  key_block              Buffer receiving the key block
+ * \param[in]      key_block_length       Length of the key block, at least 16
+ *
+ * \retval  #OPTIGA_LIB_SUCCESS                             Successful invocation
+ * \retval  #OPTIGA_LIB_ERROR                               Wrong Input arguments provided or a command failed
+ */
+LIBRARY_EXPORTS optiga_lib_status_t optiga_crypt_tls12_key_schedule(optiga_key_id_t private_key,
+                                                                    public_key_from_host_t * public_key,
+                                                                    optiga_key_id_t session_id,
+                                                                    const uint8_t * client_random,
+                                                                    const uint8_t * server_random,
+                                                                    uint8_t * key_block,
+                                                                    uint16_t key_block_length);
+
+/**
+ * @brief Gets the statistics of #optiga_crypt_tls12_key_schedule.
+ *
+ * \param[out]  p_stats                   Pointer to #optiga_crypt_tls12_key_schedule_stats_t to be filled, must not be NULL
+ */
+LIBRARY_EXPORTS void optiga_crypt_tls12_key_schedule_get_stats(optiga_crypt_tls12_key_schedule_stats_t * p_stats);
+
 
 #ifdef __cplusplus
 }
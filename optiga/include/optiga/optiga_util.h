@@ -91,6 +91,47 @@ extern "C" {
 #define OPTIGA_UTIL_ERROR_INSTANCE_IN_USE           (0x0305)
 
 
+/**
+ * \brief Descriptor of one read of #optiga_util_read_batch.
+ */
+typedef struct optiga_util_read_item
+{
+    /// OID of data object
+    uint16_t oid;
+    /// Offset from within data object
+    uint16_t offset;
+    /// Valid pointer to the buffer to which data is read
+    uint8_t * p_buffer;
+    /// Length of data to be read, updated with the actual data length retrieved (0 on error)
+    uint16_t length;
+    /// Result of the read, same values as returned by #optiga_util_read_data
+    optiga_lib_status_t status;
+} optiga_util_read_item_t;
+
+/**
+ * \brief Sink of #optiga_util_read_data_stream, consumes a chunk read from the data object.
+ *
+ * \param[in] p_ctx     Context passed to #optiga_util_read_data_stream
+ * \param[in] offset    Offset of the chunk within the data object
+ * \param[in] p_data    Chunk data, only valid during the call
+ * \param[in] length    Length of the chunk
+ *
+ * \retval  #OPTIGA_LIB_SUCCESS to continue, any other value stops the read and is returned to the caller
+ */
+typedef optiga_lib_status_t (*optiga_util_read_sink_t)(void * p_ctx, uint16_t offset, const uint8_t * p_data, uint16_t length);
+
+/**
+ * \brief Source of #optiga_util_write_data_stream, provides the next chunk to be written to the data object.
+ *
+ * \param[in]     p_ctx     Context passed to #optiga_util_write_data_stream
+ * \param[in]     offset    Offset of the chunk within the data object
+ * \param[out]    p_data    Buffer receiving the chunk
+ * \param[in,out] p_length  Size of the buffer, updated with the length of the chunk. 0 ends the write.
+ *
+ * \retval  #OPTIGA_LIB_SUCCESS to continue, any other value stops the write and is returned to the caller
+ */
+typedef optiga_lib_status_t (*optiga_util_write_source_t)(void * p_ctx, uint16_t offset, uint8_t * p_data, uint16_t * p_length);
+
 /**
  * \brief  Typedef for OIDs
  */
@@ -212,6 +253,72 @@ LIBRARY_EXPORTS optiga_lib_status_t optiga_util_read_data(uint16_t optiga_oid,
                                                           uint8_t * buffer,
                                                           uint16_t * bytes_to_read);
 
+/**
+ * @brief Reads several data objects from optiga.
+ *
+ * Performs the reads described by the items back-to-back.<br>
+ *
+ *<b>Pre Conditions:</b>
+ * - The application on OPTIGA must be opened using #optiga_util_open_application before using this API.<br>
+ *
+ *<b>API Details:</b>
+ * - Holds the lock for the complete batch and reads the data objects in the given order, each like #optiga_util_read_data.<br>
+ * - A failing read does not stop the batch, the result of each read is returned in its <b>status</b> field.<br>
+ *<br>
+ *
+ *<b>Notes:</b>
+ * - The <b>length</b> field of an item must not exceed the size of its buffer.<br>
+ * - The other users of OPTIGA are blocked until the batch completes.<br>
+ *
+ * \param[in,out]  p_items        Valid pointer to the array of read descriptors
+ * \param[in]      item_count     Number of read descriptors
+ *
+ * \retval  #OPTIGA_LIB_SUCCESS                               All the reads are successful
+ * \retval  #OPTIGA_LIB_ERROR                                 At least one read failed, see the status of the items
+ * \retval  #OPTIGA_UTIL_ERROR_INVALID_INPUT                   Wrong Input arguments provided
+ */
+LIBRARY_EXPORTS optiga_lib_status_t optiga_util_read_batch(optiga_util_read_item_t * p_items,
+                                                           uint8_t item_count);
+
+/**
+ * @brief Reads a data object from optiga in chunks.
+ *
+ * Reads the data object chunk by chunk and passes every chunk to the sink.<br>
+ *
+ *<b>Pre Conditions:</b>
+ * - The application on OPTIGA must be opened using #optiga_util_open_application before using this API.<br>
+ *
+ *<b>API Details:</b>
+ * - Every chunk is read with one command, a chunk is at most the maximum communication buffer size less the APDU header.<br>
+ * - The read stops after <b>length</b> bytes, at the end of the data object or when the sink does not return #OPTIGA_LIB_SUCCESS.<br>
+ * - The lock is released while the sink runs, the sink may use the other APIs of this module.<br>
+ *<br>
+ *
+ *<b>Notes:</b>
+ * - Only one chunk is buffered, independent of the size of the data object. The chunk buffer is taken from the
+ *   CommandLib APDU buffer pool for the whole read, CMDLIB_APDU_POOL_COUNT must exceed the number of streams
+ *   running at the same time, otherwise the remaining buffers are allocated with OCP_MALLOC.<br>
+ * - The data object may be written by another user in between two chunks.<br>
+ *
+ * \param[in]      optiga_oid     OID of data object
+ * \param[in]      offset         Offset from within data object
+ * \param[in]      length         Maximum number of bytes to read
+ * \param[in]      sink           Sink receiving the chunks
+ * \param[in]      p_ctx          Context passed to the sink
+ * \param[out]     p_total_length Pointer receiving the number of bytes passed to the sink, can be NULL
+ *
+ * \retval  #OPTIGA_LIB_SUCCESS                               All the data is read
+ * \retval  #OPTIGA_UTIL_ERROR_INVALID_INPUT                   Wrong Input arguments provided
+ * \retval  #OPTIGA_UTIL_ERROR_MEMORY_INSUFFICIENT             No chunk buffer available
+ * \retval  #OPTIGA_DEVICE_ERROR                               Command execution failure in OPTIGA and the LSB indicates the error code.(Refer Solution Reference Manual)
+ */
+LIBRARY_EXPORTS optiga_lib_status_t optiga_util_read_data_stream(uint16_t optiga_oid,
+                                                                 uint16_t offset,
+                                                                 uint16_t length,
+                                                                 optiga_util_read_sink_t sink,
+                                                                 void * p_ctx,
+                                                                 uint16_t * p_total_length);
+
 /**
  * @brief Reads metadata of a data object from optiga.
  *
@@ -281,6 +388,43 @@ LIBRARY_EXPORTS optiga_lib_status_t optiga_util_write_data(uint16_t optiga_oid,
                                                            uint8_t * buffer,
                                                            uint16_t bytes_to_write);
 
+/**
+ * @brief Writes a data object to optiga in chunks.
+ *
+ * Pulls the data chunk by chunk from the source and writes every chunk to the data object.<br>
+ *
+ *<b>Pre Conditions:</b>
+ * - The application on OPTIGA must be opened using #optiga_util_open_application before using this API.<br>
+ *
+ *<b>API Details:</b>
+ * - Every chunk is written with one command, a chunk is at most the maximum communication buffer size less the command overhead.<br>
+ * - #OPTIGA_UTIL_ERASE_AND_WRITE applies to the first chunk only, the following chunks are appended with #OPTIGA_UTIL_WRITE_ONLY.<br>
+ * - The write stops when the source provides an empty chunk or does not return #OPTIGA_LIB_SUCCESS.<br>
+ * - The lock is released while the source runs, the source may use the other APIs of this module.<br>
+ *<br>
+ *
+ *<b>Notes:</b>
+ * - The chunk buffer is taken from the CommandLib APDU buffer pool for the whole write, CMDLIB_APDU_POOL_COUNT
+ *   must exceed the number of streams running at the same time, otherwise the remaining buffers are allocated
+ *   with OCP_MALLOC.<br>
+ *
+ * \param[in]      optiga_oid     OID of data object
+ * \param[in]      write_type     Type of the write operation. Can be OPTIGA_UTIL_ERASE_AND_WRITE or OPTIGA_UTIL_WRITE_ONLY
+ * \param[in]      offset         Offset from within data object
+ * \param[in]      source         Source providing the chunks
+ * \param[in]      p_ctx          Context passed to the source
+ *
+ * \retval  #OPTIGA_LIB_SUCCESS                               All the data is written
+ * \retval  #OPTIGA_UTIL_ERROR_INVALID_INPUT                   Wrong Input arguments provided
+ * \retval  #OPTIGA_UTIL_ERROR_MEMORY_INSUFFICIENT             No chunk buffer available
+ * \retval  #OPTIGA_DEVICE_ERROR                               Command execution failure in OPTIGA and the LSB indicates the error code.(Refer Solution Reference Manual)
+ */
+LIBRARY_EXPORTS optiga_lib_status_t optiga_util_write_data_stream(uint16_t optiga_oid,
+                                                                  uint8_t write_type,
+                                                                  uint16_t offset,
+                                                                  optiga_util_write_source_t source,
+                                                                  void * p_ctx);
+
 /**
  * @brief Writes metadata for the user provided data object.
  *
@@ -312,6 +456,143 @@ LIBRARY_EXPORTS optiga_lib_status_t optiga_util_write_data(uint16_t optiga_oid,
 LIBRARY_EXPORTS optiga_lib_status_t optiga_util_write_metadata(uint16_t optiga_oid,
                                                                uint8_t * buffer,
                                                                uint8_t bytes_to_write);
+
+#if defined(OPTIGA_UTIL_CACHE_ENTRIES) || defined(OPTIGA_UTIL_PERSISTENT_CACHE)
+/**
+ * \brief Cacheability policy, returns TRUE if reads of the data object may be served from the cache.
+ */
+typedef bool_t (*optiga_util_cache_policy_t)(uint16_t optiga_oid);
+#endif
+
+#ifdef OPTIGA_UTIL_CACHE_ENTRIES
+/**
+ * \brief Counters of the data object cache.
+ */
+typedef struct optiga_util_cache_stats
+{
+    /// Number of blocks served from the cache
+    uint32_t hit_count;
+    /// Number of blocks read from OPTIGA into the cache
+    uint32_t miss_count;
+    /// Number of valid blocks replaced by another block
+    uint32_t eviction_count;
+    /// Number of blocks dropped by writes or explicit invalidation
+    uint32_t invalidation_count;
+} optiga_util_cache_stats_t;
+
+/**
+ * @brief Default cacheability policy of the data object cache.
+ *
+ *<b>API Details:</b>
+ * - Returns FALSE for data objects which change without a write from the host (life cycle and security status,
+ *   security event counter, monotonic counters, error codes) and for the configuration objects
+ *   (sleep mode activation delay, current limitation), TRUE for all the others.<br>
+ *<br>
+ *
+ * \param[in]      optiga_oid     OID of data object
+ *
+ * \retval  TRUE                                              Data object may be cached
+ * \retval  FALSE                                             Data object is always read from OPTIGA
+ */
+LIBRARY_EXPORTS bool_t optiga_util_cache_default_policy(uint16_t optiga_oid);
+
+/**
+ * @brief Sets the cacheability policy of the data object cache.
+ *
+ *<b>API Details:</b>
+ * - #optiga_util_read_data serves reads of data objects accepted by the policy from a host side cache.<br>
+ * - The cache holds OPTIGA_UTIL_CACHE_ENTRIES blocks of OPTIGA_UTIL_CACHE_BLOCK_SIZE bytes, the least recently used block is replaced.<br>
+ * - A read which misses the cache reads the complete block from OPTIGA (read-ahead).<br>
+ * - #optiga_util_write_data and #optiga_util_write_metadata invalidate the blocks of the written data object.<br>
+ * - The cache is flushed when the policy is changed.<br>
+ *<br>
+ *
+ *<b>Notes:</b>
+ * - A block stays in the cache until it is evicted or invalidated, data objects written by other means than this module
+ *   must be invalidated with #optiga_util_cache_invalidate.<br>
+ *
+ * \param[in]      policy         Cacheability policy, NULL selects #optiga_util_cache_default_policy
+ */
+LIBRARY_EXPORTS void optiga_util_cache_set_policy(optiga_util_cache_policy_t policy);
+
+/**
+ * @brief Drops the cached blocks of a data object.
+ *
+ * \param[in]      optiga_oid     OID of data object
+ */
+LIBRARY_EXPORTS void optiga_util_cache_invalidate(uint16_t optiga_oid);
+
+/**
+ * @brief Drops all the cached blocks.
+ */
+LIBRARY_EXPORTS void optiga_util_cache_flush(void);
+
+/**
+ * @brief Reads the counters of the data object cache.
+ *
+ * \param[out]     p_stats        Pointer to the buffer receiving the counters
+ */
+LIBRARY_EXPORTS void optiga_util_cache_get_stats(optiga_util_cache_stats_t * p_stats);
+#endif
+
+#ifdef OPTIGA_UTIL_PERSISTENT_CACHE
+/**
+ * @brief Default policy of the persistent cache.
+ *
+ *<b>API Details:</b>
+ * - Returns TRUE for the data objects which cannot change during the life time of the chip:
+ *   the coprocessor UID and the device certificate issued by Infineon.<br>
+ *<br>
+ *
+ * \param[in]      optiga_oid     OID of data object
+ *
+ * \retval  TRUE                                              Data object and its metadata may be persisted
+ * \retval  FALSE                                             Data object is not persisted
+ */
+LIBRARY_EXPORTS bool_t optiga_util_persistent_cache_default_policy(uint16_t optiga_oid);
+
+/**
+ * @brief Opens the persistent cache of immutable data objects.
+ *
+ *<b>Pre Conditions:</b>
+ * - The application on OPTIGA must be opened using #optiga_util_open_application before using this API.<br>
+ *
+ *<b>API Details:</b>
+ * - Maps the datastore p_name with #pal_os_datastore_map, OPTIGA_UTIL_PERSISTENT_CACHE_SIZE bytes.<br>
+ * - Reads the coprocessor UID from OPTIGA. The datastore is reset, if it was written for another chip or
+ *   by another version of this module.<br>
+ * - Afterwards #optiga_util_read_data and #optiga_util_read_metadata of data objects accepted by the policy are served
+ *   from the datastore, the complete data object is read from OPTIGA and persisted at the first access.<br>
+ * - #optiga_util_write_data and #optiga_util_write_metadata drop the persisted data object.<br>
+ *<br>
+ *
+ *<b>Notes:</b>
+ * - Several processes may share the datastore, every access to it holds #pal_os_datastore_lock.
+ *   Every persisted data object is also protected by a checksum, an entry found damaged,
+ *   e.g. by a process killed during an update, is ignored and read from OPTIGA again.<br>
+ * - Data objects written by other means than this module are not detected, the policy must only accept data objects
+ *   which are not changed in the field.<br>
+ *
+ * \param[in]      p_name         Name of the datastore (file path on Linux)
+ *
+ * \retval  #OPTIGA_LIB_SUCCESS                               Persistent cache opened
+ * \retval  #OPTIGA_LIB_ERROR                                 Datastore could not be mapped
+ * \retval  #OPTIGA_DEVICE_ERROR                              Command execution failure in OPTIGA and the LSB indicates the error code.(Refer Solution Reference Manual)
+ */
+LIBRARY_EXPORTS optiga_lib_status_t optiga_util_persistent_cache_open(const char_t * p_name);
+
+/**
+ * @brief Writes back and unmaps the persistent cache opened with #optiga_util_persistent_cache_open.
+ */
+LIBRARY_EXPORTS void optiga_util_persistent_cache_close(void);
+
+/**
+ * @brief Sets the policy of the persistent cache.
+ *
+ * \param[in]      policy         Policy, NULL selects #optiga_util_persistent_cache_default_policy
+ */
+LIBRARY_EXPORTS void optiga_util_persistent_cache_set_policy(optiga_util_cache_policy_t policy);
+#endif
 #ifdef __cplusplus
 }
 #endif
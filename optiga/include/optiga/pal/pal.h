@@ -38,6 +38,7 @@
  * HEADER FILES
  *********************************************************************************************************************/
 #include "optiga/common/Datatypes.h"
+#include "optiga/pal/pal_os_config.h"
 
 /**********************************************************************************************************************
  * pal.h
@@ -93,6 +93,15 @@ pal_status_t pal_i2c_write(pal_i2c_t* p_i2c_context, uint8_t* p_data , uint16_t
  */
 pal_status_t pal_i2c_read(pal_i2c_t* p_i2c_context, uint8_t* p_data , uint16_t length);
 
+/**
+ * @brief Writes and then reads on I2C bus in one transaction (repeated start).
+ *
+ * Optional, only required if #PL_COMBINED_REGISTER_READ is enabled.
+ * The upper layer event handler is invoked once, after the read is complete.
+ */
+pal_status_t pal_i2c_write_read(pal_i2c_t* p_i2c_context, uint8_t* p_tx_data, uint16_t tx_length,
+                                uint8_t* p_rx_data, uint16_t rx_length);
+
 /**
  * @brief De-initializes the I2C master.
  */
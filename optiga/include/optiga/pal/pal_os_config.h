@@ -0,0 +1,66 @@
+/**
+* MIT License
+*
+* Copyright (c) 2018 Infineon Technologies AG
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE
+*
+*
+* \file
+*
+* \brief This file selects the optional features of the platform abstraction layer
+*
+* The PAL and the host library must see the same PAL_OS_HAS_xxx switches: the library only protects its shared
+* state with the critical section and only waits on the notification if the switch is visible to it. This header
+* is included by pal.h, so all PAL headers, PAL sources and library sources get the same set.
+*
+* A port either defines PAL_OS_CONFIG_FILE to the name of a header with its switches, or selects one of the
+* reference implementations below, for the whole build:
+* - OPTIGA_PAL_LINUX for <repo_root>/pal/linux (default on a Linux host when PAL_OS_CONFIG_FILE is not defined)
+*
+* \ingroup  grPAL
+* @{
+*/
+
+
+#ifndef _PAL_OS_CONFIG_H_
+#define _PAL_OS_CONFIG_H_
+
+#if defined(PAL_OS_CONFIG_FILE)
+#include PAL_OS_CONFIG_FILE
+#elif defined(OPTIGA_PAL_LINUX) || defined(__linux__)
+/// pal_os_lock_acquire_timeout
+#define PAL_OS_HAS_LOCK_TIMEOUT
+/// pal_os_lock_get_stats, pal_os_lock_reset_stats
+#define PAL_OS_HAS_LOCK_STATS
+/// pal_os_lock_enter_critical_section, pal_os_lock_exit_critical_section
+#define PAL_OS_HAS_CRITICAL_SECTION
+/// pal_os_lock_wait_for_notification, pal_os_lock_notify
+#define PAL_OS_HAS_NOTIFICATION
+/// pal_os_event_init
+#define PAL_OS_HAS_EVENT_INIT
+/// pal_os_event_cancel
+#define PAL_OS_HAS_EVENT_CANCEL
+#endif
+
+#endif /* _PAL_OS_CONFIG_H_ */
+
+/**
+* @}
+*/
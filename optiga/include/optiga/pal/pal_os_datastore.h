@@ -0,0 +1,126 @@
+/**
+* MIT License
+*
+* Copyright (c) 2018 Infineon Technologies AG
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE
+*
+*
+*
+* \file
+*
+* \brief This file implements the prototype declarations of pal os datastore functionalities.
+*
+* \ingroup  grPAL
+* @{
+*/
+#ifndef _PAL_OS_DATASTORE_H_
+#define _PAL_OS_DATASTORE_H_
+
+/**********************************************************************************************************************
+ * HEADER FILES
+ *********************************************************************************************************************/
+ 
+#include "optiga/pal/pal.h"
+
+/**********************************************************************************************************************
+ * API Prototypes
+ *********************************************************************************************************************/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   Maps a persistent datastore into memory.
+ *
+ *<b>Pre-conditions:</b>
+ * None.<br>
+ *
+ *<b>API Details:</b>
+ * - Maps the datastore identified by p_name (e.g. a file path) with at least size bytes into the address space.<br>
+ * - Changes to the mapped memory are persisted and visible to other users of the same datastore.<br>
+ * - Other users, e.g. other processes, may change it at any time unless it is locked with #pal_os_datastore_lock.<br>
+ * - A newly created datastore reads as zero.<br>
+ * - Returns #PAL_STATUS_FAILURE if the datastore cannot be mapped.<br>
+ *<br>
+ *
+ * \param[in]  p_name       Name of the datastore
+ * \param[in]  size         Size of the datastore in bytes
+ * \param[out] pp_memory    Pointer receiving the address of the mapped datastore
+ *
+ */
+pal_status_t pal_os_datastore_map(const char_t * p_name, uint32_t size, void ** pp_memory);
+
+/**
+ * @brief   Writes the changes of the mapped datastore back to the persistent storage.
+ *
+ *<b>Pre-conditions:</b>
+ * The datastore is mapped with #pal_os_datastore_map.<br>
+ *
+ * \param[in]  p_memory     Address of the mapped datastore
+ * \param[in]  size         Size of the datastore in bytes
+ *
+ */
+void pal_os_datastore_sync(void * p_memory, uint32_t size);
+
+/**
+ * @brief   Unmaps a datastore mapped with #pal_os_datastore_map.
+ *
+ * \param[in]  p_memory     Address of the mapped datastore
+ * \param[in]  size         Size of the datastore in bytes
+ *
+ */
+void pal_os_datastore_unmap(void * p_memory, uint32_t size);
+
+/**
+ * @brief   Gets exclusive access to a mapped datastore across all its users.
+ *
+ *<b>Pre-conditions:</b>
+ * The datastore is mapped with #pal_os_datastore_map.<br>
+ *
+ *<b>API Details:</b>
+ * - Waits until no other user, e.g. another process, holds the lock of the same datastore.<br>
+ * - Does not serialize the threads of the calling process, the caller does.<br>
+ * - Returns #PAL_STATUS_FAILURE if the lock cannot be taken, the datastore must not be accessed then.<br>
+ *<br>
+ *
+ * \param[in]  p_memory     Address of the mapped datastore
+ *
+ */
+pal_status_t pal_os_datastore_lock(void * p_memory);
+
+/**
+ * @brief   Releases the lock taken with #pal_os_datastore_lock.
+ *
+ * \param[in]  p_memory     Address of the mapped datastore
+ *
+ */
+void pal_os_datastore_unlock(void * p_memory);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _PAL_OS_DATASTORE_H_ */
+
+/**
+* @}
+*/
+
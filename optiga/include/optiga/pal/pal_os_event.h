@@ -70,6 +70,15 @@ pal_status_t pal_os_event_init(void);
  */
 void pal_os_event_register_callback_oneshot(register_callback callback, void* callback_args, uint32_t time_us);
 
+#ifdef PAL_OS_HAS_EVENT_CANCEL
+/**
+ * @brief Cancels the pending callback registered with the given callback arguments.
+ *
+ * Returns #PAL_STATUS_FAILURE if no callback is pending for callback_args.
+ */
+pal_status_t pal_os_event_cancel(void* callback_args);
+#endif
+
 
 
 #endif //_PAL_OS_EVENT_H_
@@ -39,6 +39,27 @@ extern "C" {
 
 #include "pal.h"
 
+#ifdef PAL_OS_HAS_LOCK_STATS
+/**
+ * @brief Contention counters of the PAL OS lock.
+ */
+typedef struct pal_os_lock_stats
+{
+    /// Number of acquire calls (blocking and timed)
+    uint32_t acquire_count;
+    /// Number of acquire calls which had to wait for another owner
+    uint32_t contended_count;
+    /// Number of timed acquire calls which gave up
+    uint32_t timeout_count;
+    /// Highest number of threads waiting at the same time
+    uint32_t max_waiters;
+    /// Accumulated wait time of the contended acquire calls in microseconds
+    uint64_t total_wait_time_us;
+    /// Longest single wait in microseconds
+    uint64_t max_wait_time_us;
+} pal_os_lock_stats_t;
+#endif
+
 /**
  * @brief   Acquires a lock.
  *
@@ -47,12 +68,32 @@ extern "C" {
  *
  *<b>API Details:</b>
  * - Acquires the lock.<br>
+ * - Platforms with a blocking lock (e.g. Linux) wait until the lock is available and always return #PAL_STATUS_SUCCESS.<br>
+ * - Other platforms return #PAL_STATUS_FAILURE if the lock is held, the caller is expected to retry.<br>
  *<br>
  *
  *
  */
 pal_status_t pal_os_lock_acquire(void);
 
+#ifdef PAL_OS_HAS_LOCK_TIMEOUT
+/**
+ * @brief   Acquires the lock, waiting at most the given time.
+ *
+ *<b>Pre-conditions:</b>
+ * None.<br>
+ *
+ *<b>API Details:</b>
+ * - Waits in FIFO order with the other callers until the lock is available or the timeout elapses.<br>
+ * - Returns #PAL_STATUS_FAILURE if the lock could not be acquired within timeout_ms.<br>
+ *<br>
+ *
+ * \param[in] timeout_ms Maximum time to wait in milliseconds
+ *
+ */
+pal_status_t pal_os_lock_acquire_timeout(uint32_t timeout_ms);
+#endif
+
 /**
  * @brief   Releases the lock.
  *
@@ -67,6 +108,101 @@ pal_status_t pal_os_lock_acquire(void);
  */
 void pal_os_lock_release(void);
 
+#ifdef PAL_OS_HAS_LOCK_STATS
+/**
+ * @brief   Reads the contention counters of the lock.
+ *
+ *<b>Pre-conditions:</b>
+ * None.<br>
+ *
+ *<b>API Details:</b>
+ * - Copies a consistent snapshot of the counters to p_stats.<br>
+ *<br>
+ *
+ * \param[out] p_stats Pointer to the buffer receiving the counters
+ *
+ */
+void pal_os_lock_get_stats(pal_os_lock_stats_t * p_stats);
+
+/**
+ * @brief   Resets the contention counters of the lock.
+ *
+ *<b>Pre-conditions:</b>
+ * None.<br>
+ *
+ *<b>API Details:</b>
+ * - Sets all the counters to zero.<br>
+ *<br>
+ *
+ *
+ */
+void pal_os_lock_reset_stats(void);
+#endif
+
+#ifdef PAL_OS_HAS_CRITICAL_SECTION
+/**
+ * @brief   Enters the critical section protecting short updates of state shared between threads.
+ *
+ *<b>Pre-conditions:</b>
+ * None.<br>
+ *
+ *<b>API Details:</b>
+ * - Independent of the lock taken with #pal_os_lock_acquire, it can be entered while that lock is held.<br>
+ * - It is not recursive. No blocking call and no callback must be made before leaving it.<br>
+ *<br>
+ *
+ *
+ */
+void pal_os_lock_enter_critical_section(void);
+
+/**
+ * @brief   Leaves the critical section entered with #pal_os_lock_enter_critical_section.
+ *
+ *<b>Pre-conditions:</b>
+ * None.<br>
+ *
+ *<b>API Details:</b>
+ * - Leaves the critical section.<br>
+ *<br>
+ *
+ *
+ */
+void pal_os_lock_exit_critical_section(void);
+#endif
+
+#ifdef PAL_OS_HAS_NOTIFICATION
+/**
+ * @brief   Blocks the caller until #pal_os_lock_notify is called or the timeout elapses.
+ *
+ *<b>Pre-conditions:</b>
+ * None.<br>
+ *
+ *<b>API Details:</b>
+ * - Behaves like a binary semaphore. A notification given while nobody waits is kept and consumed by the next wait.<br>
+ * - The caller must re-check its completion condition after returning, the notification carries no data.<br>
+ * - Returns #PAL_STATUS_FAILURE if no notification arrived within timeout_ms.<br>
+ *<br>
+ *
+ * \param[in] timeout_ms Maximum time to wait in milliseconds
+ *
+ */
+pal_status_t pal_os_lock_wait_for_notification(uint32_t timeout_ms);
+
+/**
+ * @brief   Wakes up the caller blocked in #pal_os_lock_wait_for_notification.
+ *
+ *<b>Pre-conditions:</b>
+ * None.<br>
+ *
+ *<b>API Details:</b>
+ * - Can be called from the context running the pal_os_event callbacks (e.g. the comms event handlers).<br>
+ *<br>
+ *
+ *
+ */
+void pal_os_lock_notify(void);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
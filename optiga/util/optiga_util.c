@@ -33,17 +33,641 @@
 #include "optiga/comms/optiga_comms.h"
 #include "optiga/cmd/CommandLib.h"
 #include "optiga/pal/pal_os_timer.h"
+#include "optiga/pal/pal_os_lock.h"
+#ifdef OPTIGA_UTIL_PERSISTENT_CACHE
+#include "optiga/pal/pal_os_datastore.h"
+#endif
 
 ///Length of metadata
 #define LENGTH_METADATA             0x1C
 
+///Device error returned by CmdLib_GetDataObject when the offset is beyond the end of the data object
+#define DEVICE_ERROR_OUT_OF_BOUND   ((int32_t)(CMD_DEV_ERROR | 0x08))
+
+///Bytes of a GetDataObject response in addition to the data (APDU header)
+#define READ_CHUNK_OVERHEAD         LEN_APDUHEADER
+
+///Bytes of a SetDataObject command in addition to the data (APDU header, OID and offset)
+#define WRITE_CHUNK_OVERHEAD        (LEN_APDUHEADER + 4)
+
 volatile static host_lib_status_t optiga_comms_status;
 
 #ifdef MODULE_ENABLE_READ_WRITE
 
+#ifdef OPTIGA_UTIL_CACHE_ENTRIES
+
+///Size of a cached block, a read which misses the cache reads the complete block from OPTIGA
+#ifndef OPTIGA_UTIL_CACHE_BLOCK_SIZE
+#define OPTIGA_UTIL_CACHE_BLOCK_SIZE    1024
+#endif
+
+/// @cond hidden
+typedef struct optiga_util_cache_entry
+{
+    /// OID of the cached data object
+    uint16_t oid;
+    /// Offset of the block within the data object, multiple of OPTIGA_UTIL_CACHE_BLOCK_SIZE
+    uint16_t offset;
+    /// Number of valid bytes, less than the block size if the data object ends within the block
+    uint16_t length;
+    /// TRUE if the entry holds a block
+    uint8_t valid;
+    /// Value of the use counter at the last access, the lowest one is replaced first
+    uint32_t last_use;
+    /// Cached data
+    uint8_t data[OPTIGA_UTIL_CACHE_BLOCK_SIZE];
+} optiga_util_cache_entry_t;
+
+// The cache is only accessed with the PAL OS lock held
+static optiga_util_cache_entry_t optiga_util_cache[OPTIGA_UTIL_CACHE_ENTRIES];
+static uint32_t optiga_util_cache_use_counter;
+static optiga_util_cache_stats_t optiga_util_cache_stats;
+static optiga_util_cache_policy_t optiga_util_cache_policy = optiga_util_cache_default_policy;
+/// @endcond
+
+bool_t optiga_util_cache_default_policy(uint16_t optiga_oid)
+{
+    bool_t cacheable = TRUE;
+
+    switch (optiga_oid)
+    {
+        case eLCS_G:
+        case eSECURITY_STATUS_G:
+        case eSLEEP_MODE_ACTIVATION_DELAY:
+        case eCURRENT_LIMITATION:
+        case eSECURITY_EVENT_COUNTER:
+        case eLCS_A:
+        case eSECURITY_STATUS_A:
+        case eERROR_CODES:
+        // Monotonic counters
+        case 0xE120:
+        case 0xE121:
+        case 0xE122:
+        case 0xE123:
+            cacheable = FALSE;
+            break;
+        default:
+            break;
+    }
+    return cacheable;
+}
+
+static void optiga_util_cache_drop(uint16_t optiga_oid, uint8_t all_objects)
+{
+    uint8_t index;
+
+    for (index = 0; index < OPTIGA_UTIL_CACHE_ENTRIES; index++)
+    {
+        if ((TRUE == optiga_util_cache[index].valid) &&
+            ((TRUE == all_objects) || (optiga_oid == optiga_util_cache[index].oid)))
+        {
+            optiga_util_cache[index].valid = FALSE;
+            optiga_util_cache_stats.invalidation_count++;
+        }
+    }
+}
+
+static optiga_util_cache_entry_t * optiga_util_cache_lookup(uint16_t optiga_oid, uint16_t block_offset)
+{
+    uint8_t index;
+
+    for (index = 0; index < OPTIGA_UTIL_CACHE_ENTRIES; index++)
+    {
+        if ((TRUE == optiga_util_cache[index].valid) && (optiga_oid == optiga_util_cache[index].oid) &&
+            (block_offset == optiga_util_cache[index].offset))
+        {
+            return &optiga_util_cache[index];
+        }
+    }
+    return NULL;
+}
+
+// Reads the complete block from OPTIGA into the least recently used entry
+static optiga_util_cache_entry_t * optiga_util_cache_fill(uint16_t optiga_oid, uint16_t block_offset, int32_t * p_status)
+{
+    optiga_util_cache_entry_t * p_entry = &optiga_util_cache[0];
+    sGetData_d cmd_params;
+    sCmdResponse_d cmd_resp;
+    uint8_t index;
+
+    for (index = 0; index < OPTIGA_UTIL_CACHE_ENTRIES; index++)
+    {
+        if (FALSE == optiga_util_cache[index].valid)
+        {
+            p_entry = &optiga_util_cache[index];
+            break;
+        }
+        if (optiga_util_cache[index].last_use < p_entry->last_use)
+        {
+            p_entry = &optiga_util_cache[index];
+        }
+    }
+    if (TRUE == p_entry->valid)
+    {
+        optiga_util_cache_stats.eviction_count++;
+        p_entry->valid = FALSE;
+    }
+
+    cmd_params.wOID = optiga_oid;
+    cmd_params.wLength = OPTIGA_UTIL_CACHE_BLOCK_SIZE;
+    cmd_params.wOffset = block_offset;
+    cmd_params.eDataOrMdata = eDATA;
+
+    cmd_resp.prgbBuffer = p_entry->data;
+    cmd_resp.wBufferLength = OPTIGA_UTIL_CACHE_BLOCK_SIZE;
+    cmd_resp.wRespLength = 0;
+
+    *p_status = CmdLib_GetDataObject(&cmd_params, &cmd_resp);
+    if (CMD_LIB_OK != *p_status)
+    {
+        return NULL;
+    }
+
+    p_entry->oid = optiga_oid;
+    p_entry->offset = block_offset;
+    p_entry->length = cmd_resp.wRespLength;
+    p_entry->valid = TRUE;
+    optiga_util_cache_stats.miss_count++;
+    return p_entry;
+}
+
+/*
+ * Serves the read from the cache, missing blocks are read from OPTIGA.
+ * Reads which cannot be served (not cacheable, offset beyond the data object) are passed to OPTIGA as they are,
+ * so the caller gets the same result as without the cache.
+ */
+static int32_t optiga_util_cache_read(const sGetData_d * p_params, sCmdResponse_d * p_resp)
+{
+    int32_t status = (int32_t)CMD_LIB_OK;
+    optiga_util_cache_entry_t * p_entry;
+    uint32_t position = p_params->wOffset;
+    uint32_t end = position + p_params->wLength;
+    uint16_t block_offset;
+    uint16_t block_position;
+    uint16_t copy_length;
+    uint16_t copied = 0;
+
+    if ((eDATA != p_params->eDataOrMdata) || (!optiga_util_cache_policy(p_params->wOID)))
+    {
+        return CmdLib_GetDataObject(p_params, p_resp);
+    }
+
+    while (position < end)
+    {
+        block_offset = (uint16_t)(position - (position % OPTIGA_UTIL_CACHE_BLOCK_SIZE));
+        block_position = (uint16_t)(position - block_offset);
+
+        p_entry = optiga_util_cache_lookup(p_params->wOID, block_offset);
+        if (NULL != p_entry)
+        {
+            optiga_util_cache_stats.hit_count++;
+        }
+        else
+        {
+            p_entry = optiga_util_cache_fill(p_params->wOID, block_offset, &status);
+            if (NULL == p_entry)
+            {
+                break;
+            }
+        }
+        p_entry->last_use = ++optiga_util_cache_use_counter;
+
+        // End of the data object
+        if (block_position >= p_entry->length)
+        {
+            break;
+        }
+        copy_length = p_entry->length - block_position;
+        if (copy_length > (end - position))
+        {
+            copy_length = (uint16_t)(end - position);
+        }
+        memcpy(p_resp->prgbBuffer + copied, p_entry->data + block_position, copy_length);
+        copied += copy_length;
+        position += copy_length;
+
+        if (p_entry->length < OPTIGA_UTIL_CACHE_BLOCK_SIZE)
+        {
+            break;
+        }
+    }
+
+    if (0 == copied)
+    {
+        return CmdLib_GetDataObject(p_params, p_resp);
+    }
+    // A read ending exactly at the end of the data object fails for the following block, anything else is an error
+    if ((CMD_LIB_OK != status) && (DEVICE_ERROR_OUT_OF_BOUND != status))
+    {
+        memset(p_resp->prgbBuffer, 0, copied);
+        p_resp->wRespLength = 0;
+        return status;
+    }
+    p_resp->wRespLength = copied;
+    return (int32_t)CMD_LIB_OK;
+}
+
+void optiga_util_cache_set_policy(optiga_util_cache_policy_t policy)
+{
+    while (pal_os_lock_acquire() != PAL_STATUS_SUCCESS);
+    optiga_util_cache_policy = (NULL != policy) ? policy : optiga_util_cache_default_policy;
+    optiga_util_cache_drop(0, TRUE);
+    pal_os_lock_release();
+}
+
+void optiga_util_cache_invalidate(uint16_t optiga_oid)
+{
+    while (pal_os_lock_acquire() != PAL_STATUS_SUCCESS);
+    optiga_util_cache_drop(optiga_oid, FALSE);
+    pal_os_lock_release();
+}
+
+void optiga_util_cache_flush(void)
+{
+    while (pal_os_lock_acquire() != PAL_STATUS_SUCCESS);
+    optiga_util_cache_drop(0, TRUE);
+    pal_os_lock_release();
+}
+
+void optiga_util_cache_get_stats(optiga_util_cache_stats_t * p_stats)
+{
+    if (NULL != p_stats)
+    {
+        while (pal_os_lock_acquire() != PAL_STATUS_SUCCESS);
+        *p_stats = optiga_util_cache_stats;
+        pal_os_lock_release();
+    }
+}
+#endif // OPTIGA_UTIL_CACHE_ENTRIES
+
+#ifdef OPTIGA_UTIL_PERSISTENT_CACHE
+
+///Size of the datastore holding the persistent cache
+#ifndef OPTIGA_UTIL_PERSISTENT_CACHE_SIZE
+#define OPTIGA_UTIL_PERSISTENT_CACHE_SIZE   8192
+#endif
+
+///Largest data object persisted (certificate data objects)
+#define OPTIGA_UTIL_STORE_MAX_OBJECT        1728
+///Identifies a datastore written by this module
+#define OPTIGA_UTIL_STORE_MAGIC             0x4F505843
+///Layout version, a datastore with another version is reset
+#define OPTIGA_UTIL_STORE_VERSION           1
+///Maximum length of the coprocessor UID
+#define OPTIGA_UTIL_STORE_UID_LENGTH        32
+///Records start at multiples of 4 bytes
+#define OPTIGA_UTIL_STORE_ALIGN(length)     (((length) + 3) & ~((uint32_t)3))
+
+/// @cond hidden
+typedef struct optiga_util_store_header
+{
+    /// OPTIGA_UTIL_STORE_MAGIC once the header is initialized
+    uint32_t magic;
+    /// OPTIGA_UTIL_STORE_VERSION
+    uint16_t version;
+    /// Length of the UID of the chip the datastore belongs to
+    uint16_t uid_length;
+    /// UID of the chip the datastore belongs to
+    uint8_t uid[OPTIGA_UTIL_STORE_UID_LENGTH];
+    /// OPTIGA_UTIL_PERSISTENT_CACHE_SIZE
+    uint32_t size;
+    /// Number of bytes used by the header and the records
+    uint32_t used;
+} optiga_util_store_header_t;
+
+// A record is followed by its data, padded to the alignment
+typedef struct optiga_util_store_record
+{
+    /// OID of the data object
+    uint16_t oid;
+    /// eDATA or eMETA_DATA
+    uint8_t type;
+    /// TRUE until the data object is written
+    uint8_t valid;
+    /// Length of the data
+    uint16_t length;
+    uint16_t reserved;
+    /// Checksum of the record fields above and the data
+    uint32_t checksum;
+} optiga_util_store_record_t;
+
+// The datastore is only accessed with the PAL OS lock and the datastore lock held, the latter
+// keeps other processes sharing the datastore out while records are validated, appended or copied
+static uint8_t * optiga_util_store;
+static optiga_util_cache_policy_t optiga_util_store_policy = optiga_util_persistent_cache_default_policy;
+/// @endcond
+
+bool_t optiga_util_persistent_cache_default_policy(uint16_t optiga_oid)
+{
+    return ((eCOPROCESSOR_UID == optiga_oid) || (eDEVICE_PUBKEY_CERT_IFX == optiga_oid)) ? TRUE : FALSE;
+}
+
+// FNV-1a over the record fields and the data
+static uint32_t optiga_util_store_checksum(const optiga_util_store_record_t * p_record)
+{
+    const uint8_t * p_data = (const uint8_t *)(p_record + 1);
+    uint32_t checksum = 0x811C9DC5;
+    uint32_t index;
+
+    checksum = (checksum ^ p_record->oid) * 0x01000193;
+    checksum = (checksum ^ p_record->type) * 0x01000193;
+    checksum = (checksum ^ p_record->length) * 0x01000193;
+    for (index = 0; index < p_record->length; index++)
+    {
+        checksum = (checksum ^ p_data[index]) * 0x01000193;
+    }
+    return checksum;
+}
+
+static optiga_util_store_record_t * optiga_util_store_lookup(uint16_t optiga_oid, uint8_t type)
+{
+    optiga_util_store_header_t * p_header = (optiga_util_store_header_t *)optiga_util_store;
+    optiga_util_store_record_t * p_record;
+    uint32_t position = sizeof(optiga_util_store_header_t);
+    uint32_t used = p_header->used;
+
+    if (used > OPTIGA_UTIL_PERSISTENT_CACHE_SIZE)
+    {
+        return NULL;
+    }
+    while ((position + sizeof(optiga_util_store_record_t)) <= used)
+    {
+        p_record = (optiga_util_store_record_t *)(optiga_util_store + position);
+        if ((position + sizeof(optiga_util_store_record_t) + p_record->length) > used)
+        {
+            break;
+        }
+        if ((TRUE == p_record->valid) && (optiga_oid == p_record->oid) && (type == p_record->type))
+        {
+            if (p_record->checksum == optiga_util_store_checksum(p_record))
+            {
+                return p_record;
+            }
+            p_record->valid = FALSE;
+        }
+        position += OPTIGA_UTIL_STORE_ALIGN(sizeof(optiga_util_store_record_t) + p_record->length);
+    }
+    return NULL;
+}
+
+// Reads the complete data object (or its metadata) from OPTIGA into a new record
+static optiga_util_store_record_t * optiga_util_store_fill(uint16_t optiga_oid, uint8_t type)
+{
+    optiga_util_store_header_t * p_header = (optiga_util_store_header_t *)optiga_util_store;
+    optiga_util_store_record_t * p_record;
+    uint32_t used = p_header->used;
+    sGetData_d cmd_params;
+    sCmdResponse_d cmd_resp;
+
+    // Dropped records are not reclaimed individually, a full datastore is emptied and refilled on demand
+    if ((used < sizeof(optiga_util_store_header_t)) ||
+        ((used + sizeof(optiga_util_store_record_t) + OPTIGA_UTIL_STORE_MAX_OBJECT) > OPTIGA_UTIL_PERSISTENT_CACHE_SIZE))
+    {
+        used = sizeof(optiga_util_store_header_t);
+        p_header->used = used;
+    }
+    p_record = (optiga_util_store_record_t *)(optiga_util_store + used);
+
+    cmd_params.wOID = optiga_oid;
+    cmd_params.wLength = (eDATA == type) ? OPTIGA_UTIL_STORE_MAX_OBJECT : LENGTH_METADATA;
+    cmd_params.wOffset = 0;
+    cmd_params.eDataOrMdata = (eDATA == type) ? eDATA : eMETA_DATA;
+
+    cmd_resp.prgbBuffer = (uint8_t *)(p_record + 1);
+    cmd_resp.wBufferLength = OPTIGA_UTIL_STORE_MAX_OBJECT;
+    cmd_resp.wRespLength = 0;
+
+    if (CMD_LIB_OK != CmdLib_GetDataObject(&cmd_params, &cmd_resp))
+    {
+        return NULL;
+    }
+
+    p_record->oid = optiga_oid;
+    p_record->type = type;
+    p_record->length = cmd_resp.wRespLength;
+    p_record->reserved = 0;
+    p_record->checksum = optiga_util_store_checksum(p_record);
+    p_record->valid = TRUE;
+    // Publish the record after its content
+    p_header->used = used + OPTIGA_UTIL_STORE_ALIGN(sizeof(optiga_util_store_record_t) + p_record->length);
+    pal_os_datastore_sync(optiga_util_store, OPTIGA_UTIL_PERSISTENT_CACHE_SIZE);
+
+    return p_record;
+}
+
+/*
+ * Serves the read from the persistent cache. Returns FALSE if the read has to be sent to OPTIGA,
+ * i.e. the data object is not persisted and cannot be persisted or the offset is beyond the data object.
+ */
+static bool_t optiga_util_store_read(const sGetData_d * p_params, sCmdResponse_d * p_resp, int32_t * p_status)
+{
+    optiga_util_store_record_t * p_record;
+    uint16_t offset = 0;
+    uint16_t length;
+
+    bool_t served = FALSE;
+
+    if ((NULL == optiga_util_store) || (!optiga_util_store_policy(p_params->wOID)))
+    {
+        return FALSE;
+    }
+    if (PAL_STATUS_SUCCESS != pal_os_datastore_lock(optiga_util_store))
+    {
+        return FALSE;
+    }
+
+    do
+    {
+        p_record = optiga_util_store_lookup(p_params->wOID, (uint8_t)p_params->eDataOrMdata);
+        if (NULL == p_record)
+        {
+            p_record = optiga_util_store_fill(p_params->wOID, (uint8_t)p_params->eDataOrMdata);
+            if (NULL == p_record)
+            {
+                break;
+            }
+        }
+
+        length = p_record->length;
+        if (eDATA == p_params->eDataOrMdata)
+        {
+            offset = p_params->wOffset;
+            if (offset >= length)
+            {
+                break;
+            }
+            length -= offset;
+            if (length > p_params->wLength)
+            {
+                length = p_params->wLength;
+            }
+        }
+        served = TRUE;
+        if (length > p_resp->wBufferLength)
+        {
+            p_resp->wRespLength = 0;
+            *p_status = (int32_t)CMD_LIB_INSUFFICIENT_MEMORY;
+            break;
+        }
+
+        memcpy(p_resp->prgbBuffer, (uint8_t *)(p_record + 1) + offset, length);
+        p_resp->wRespLength = length;
+        *p_status = (int32_t)CMD_LIB_OK;
+    } while (FALSE);
+    pal_os_datastore_unlock(optiga_util_store);
+
+    return served;
+}
+
+static void optiga_util_store_drop(uint16_t optiga_oid)
+{
+    optiga_util_store_record_t * p_record;
+
+    if ((NULL == optiga_util_store) || (PAL_STATUS_SUCCESS != pal_os_datastore_lock(optiga_util_store)))
+    {
+        return;
+    }
+    while (NULL != (p_record = optiga_util_store_lookup(optiga_oid, (uint8_t)eDATA)))
+    {
+        p_record->valid = FALSE;
+    }
+    while (NULL != (p_record = optiga_util_store_lookup(optiga_oid, (uint8_t)eMETA_DATA)))
+    {
+        p_record->valid = FALSE;
+    }
+    pal_os_datastore_sync(optiga_util_store, OPTIGA_UTIL_PERSISTENT_CACHE_SIZE);
+    pal_os_datastore_unlock(optiga_util_store);
+}
+
+optiga_lib_status_t optiga_util_persistent_cache_open(const char_t * p_name)
+{
+    optiga_lib_status_t status = OPTIGA_LIB_ERROR;
+    optiga_util_store_header_t * p_header;
+    uint8_t uid[OPTIGA_UTIL_STORE_UID_LENGTH];
+    sGetData_d cmd_params;
+    sCmdResponse_d cmd_resp;
+    void * p_memory = NULL;
+
+    while (pal_os_lock_acquire() != PAL_STATUS_SUCCESS);
+    do
+    {
+        if ((NULL == p_name) || (NULL != optiga_util_store))
+        {
+            break;
+        }
+
+        // The UID read is the only access to OPTIGA needed to validate the datastore
+        cmd_params.wOID = eCOPROCESSOR_UID;
+        cmd_params.wLength = sizeof(uid);
+        cmd_params.wOffset = 0;
+        cmd_params.eDataOrMdata = eDATA;
+        cmd_resp.prgbBuffer = uid;
+        cmd_resp.wBufferLength = sizeof(uid);
+        cmd_resp.wRespLength = 0;
+        status = CmdLib_GetDataObject(&cmd_params, &cmd_resp);
+        if (CMD_LIB_OK != status)
+        {
+            break;
+        }
+
+        if (PAL_STATUS_SUCCESS != pal_os_datastore_map(p_name, OPTIGA_UTIL_PERSISTENT_CACHE_SIZE, &p_memory))
+        {
+            status = OPTIGA_LIB_ERROR;
+            break;
+        }
+
+        if (PAL_STATUS_SUCCESS != pal_os_datastore_lock(p_memory))
+        {
+            pal_os_datastore_unmap(p_memory, OPTIGA_UTIL_PERSISTENT_CACHE_SIZE);
+            status = OPTIGA_LIB_ERROR;
+            break;
+        }
+        p_header = (optiga_util_store_header_t *)p_memory;
+        if ((OPTIGA_UTIL_STORE_MAGIC != p_header->magic) || (OPTIGA_UTIL_STORE_VERSION != p_header->version) ||
+            (OPTIGA_UTIL_PERSISTENT_CACHE_SIZE != p_header->size) || (cmd_resp.wRespLength != p_header->uid_length) ||
+            (0 != memcmp(p_header->uid, uid, cmd_resp.wRespLength)) ||
+            (p_header->used < sizeof(optiga_util_store_header_t)) || (p_header->used > OPTIGA_UTIL_PERSISTENT_CACHE_SIZE))
+        {
+            // Written for another chip, by another version or not yet initialized
+            p_header->magic = 0;
+            p_header->version = OPTIGA_UTIL_STORE_VERSION;
+            p_header->uid_length = cmd_resp.wRespLength;
+            memset(p_header->uid, 0, sizeof(p_header->uid));
+            memcpy(p_header->uid, uid, cmd_resp.wRespLength);
+            p_header->size = OPTIGA_UTIL_PERSISTENT_CACHE_SIZE;
+            p_header->used = sizeof(optiga_util_store_header_t);
+            p_header->magic = OPTIGA_UTIL_STORE_MAGIC;
+            pal_os_datastore_sync(p_memory, OPTIGA_UTIL_PERSISTENT_CACHE_SIZE);
+        }
+        pal_os_datastore_unlock(p_memory);
+
+        optiga_util_store = (uint8_t *)p_memory;
+        status = OPTIGA_LIB_SUCCESS;
+    } while (FALSE);
+    pal_os_lock_release();
+
+    return status;
+}
+
+void optiga_util_persistent_cache_close(void)
+{
+    while (pal_os_lock_acquire() != PAL_STATUS_SUCCESS);
+    if (NULL != optiga_util_store)
+    {
+        pal_os_datastore_sync(optiga_util_store, OPTIGA_UTIL_PERSISTENT_CACHE_SIZE);
+        pal_os_datastore_unmap(optiga_util_store, OPTIGA_UTIL_PERSISTENT_CACHE_SIZE);
+        optiga_util_store = NULL;
+    }
+    pal_os_lock_release();
+}
+
+void optiga_util_persistent_cache_set_policy(optiga_util_cache_policy_t policy)
+{
+    while (pal_os_lock_acquire() != PAL_STATUS_SUCCESS);
+    optiga_util_store_policy = (NULL != policy) ? policy : optiga_util_persistent_cache_default_policy;
+    pal_os_lock_release();
+}
+#endif // OPTIGA_UTIL_PERSISTENT_CACHE
+
+/*
+ * Reads a data object or its metadata from the persistent cache, the object cache or OPTIGA.
+ * Must be called with the PAL OS lock held.
+ */
+static int32_t optiga_util_get_data_object(const sGetData_d * p_params, sCmdResponse_d * p_resp)
+{
+#ifdef OPTIGA_UTIL_PERSISTENT_CACHE
+    int32_t status;
+
+    if (TRUE == optiga_util_store_read(p_params, p_resp, &status))
+    {
+        return status;
+    }
+#endif
+#ifdef OPTIGA_UTIL_CACHE_ENTRIES
+    return optiga_util_cache_read(p_params, p_resp);
+#else
+    return CmdLib_GetDataObject(p_params, p_resp);
+#endif
+}
+
+// Drops the cached copies of the data object, must be called with the PAL OS lock held
+static void optiga_util_invalidate_object(uint16_t optiga_oid)
+{
+#ifdef OPTIGA_UTIL_CACHE_ENTRIES
+    optiga_util_cache_drop(optiga_oid, FALSE);
+#endif
+#ifdef OPTIGA_UTIL_PERSISTENT_CACHE
+    optiga_util_store_drop(optiga_oid);
+#endif
+    (void)optiga_oid;
+}
+
 static void __optiga_util_comms_event_handler(void* upper_layer_ctx, host_lib_status_t event)
 {
 	optiga_comms_status = event;
+#ifdef PAL_OS_HAS_NOTIFICATION
+	pal_os_lock_notify();
+#endif
 }
 
 optiga_lib_status_t optiga_util_open_application(optiga_comms_t* p_comms)
@@ -66,7 +690,11 @@ optiga_lib_status_t optiga_util_open_application(optiga_comms_t* p_comms)
 		//Wait until IFX I2C initialization is complete
 		while(optiga_comms_status == OPTIGA_COMMS_BUSY)
 		{
+#ifdef PAL_OS_HAS_NOTIFICATION
+			(void)pal_os_lock_wait_for_notification(10);
+#else
 			pal_os_timer_delay_in_milliseconds(1);
+#endif
 		}
 
 		if((OPTIGA_COMMS_SUCCESS != status) || (optiga_comms_status == OPTIGA_COMMS_ERROR))
@@ -81,7 +709,9 @@ optiga_lib_status_t optiga_util_open_application(optiga_comms_t* p_comms)
 
 		//Open the application in Security Chip
 		sOpenApp.eOpenType = eInit;
+		while (pal_os_lock_acquire() != PAL_STATUS_SUCCESS);
 		status = CmdLib_OpenApplication(&sOpenApp);
+		pal_os_lock_release();
 		if(CMD_LIB_OK == status)
 		{
 			status = OPTIGA_LIB_SUCCESS;
@@ -115,7 +745,9 @@ optiga_lib_status_t optiga_util_read_data(uint16_t optiga_oid, uint16_t offset,
         cmd_resp.wBufferLength = *buffer_size;
         cmd_resp.wRespLength = 0;
 
-        status = CmdLib_GetDataObject(&cmd_params,&cmd_resp);
+        while (pal_os_lock_acquire() != PAL_STATUS_SUCCESS);
+        status = optiga_util_get_data_object(&cmd_params,&cmd_resp);
+        pal_os_lock_release();
 
         if(CMD_LIB_OK != status)
         {
@@ -128,6 +760,148 @@ optiga_lib_status_t optiga_util_read_data(uint16_t optiga_oid, uint16_t offset,
     return status;
 }
 
+optiga_lib_status_t optiga_util_read_batch(optiga_util_read_item_t * p_items, uint8_t item_count)
+{
+    int32_t status  = (int32_t)OPTIGA_LIB_SUCCESS;
+    sGetData_d cmd_params;
+    sCmdResponse_d cmd_resp;
+    optiga_util_read_item_t * p_item;
+    uint8_t index;
+
+    if((NULL == p_items) || (0 == item_count))
+    {
+        return OPTIGA_UTIL_ERROR_INVALID_INPUT;
+    }
+
+    // One lock hold for all the reads, the APDU buffer is taken from the CommandLib pool per read
+    while (pal_os_lock_acquire() != PAL_STATUS_SUCCESS);
+    for(index = 0; index < item_count; index++)
+    {
+        p_item = &p_items[index];
+        if((NULL == p_item->p_buffer) || (0 == p_item->length))
+        {
+            p_item->status = (int32_t)OPTIGA_LIB_ERROR;
+            p_item->length = 0;
+            status = (int32_t)OPTIGA_LIB_ERROR;
+            continue;
+        }
+
+        cmd_params.wOID = p_item->oid;
+        cmd_params.wLength = p_item->length;
+        cmd_params.wOffset = p_item->offset;
+        cmd_params.eDataOrMdata = eDATA;
+
+        cmd_resp.prgbBuffer = p_item->p_buffer;
+        cmd_resp.wBufferLength = p_item->length;
+        cmd_resp.wRespLength = 0;
+
+        p_item->status = optiga_util_get_data_object(&cmd_params,&cmd_resp);
+        if(CMD_LIB_OK != p_item->status)
+        {
+            p_item->length = 0;
+            status = (int32_t)OPTIGA_LIB_ERROR;
+            continue;
+        }
+        p_item->length = cmd_resp.wRespLength;
+        p_item->status = OPTIGA_LIB_SUCCESS;
+    }
+    pal_os_lock_release();
+
+    return status;
+}
+
+// Largest chunk transferred with one command, 0 if the application is not opened
+static uint16_t optiga_util_chunk_size(uint16_t overhead)
+{
+    uint16_t max_comms_buffer = CmdLib_GetMaxCommsBufferSize();
+
+    if ((0xFFFF == max_comms_buffer) || (max_comms_buffer <= overhead))
+    {
+        return 0;
+    }
+    return (max_comms_buffer - overhead);
+}
+
+optiga_lib_status_t optiga_util_read_data_stream(uint16_t optiga_oid, uint16_t offset, uint16_t length,
+                                                 optiga_util_read_sink_t sink, void * p_ctx, uint16_t * p_total_length)
+{
+    int32_t status  = (int32_t)OPTIGA_LIB_ERROR;
+    sGetData_d cmd_params;
+    sCmdResponse_d cmd_resp;
+    uint8_t * p_chunk = NULL;
+    uint16_t chunk_size;
+    uint16_t total_length = 0;
+    uint32_t position = offset;
+    uint32_t end = (uint32_t)offset + length;
+
+    do
+    {
+        if((NULL == sink) || (0 == length))
+        {
+            status = OPTIGA_UTIL_ERROR_INVALID_INPUT;
+            break;
+        }
+        chunk_size = optiga_util_chunk_size(READ_CHUNK_OVERHEAD);
+        if(0 == chunk_size)
+        {
+            break;
+        }
+        p_chunk = CmdLib_GetApduBuffer(chunk_size);
+        if(NULL == p_chunk)
+        {
+            status = OPTIGA_UTIL_ERROR_MEMORY_INSUFFICIENT;
+            break;
+        }
+
+        status = OPTIGA_LIB_SUCCESS;
+        while(position < end)
+        {
+            cmd_params.wOID = optiga_oid;
+            cmd_params.wLength = ((end - position) < chunk_size) ? (uint16_t)(end - position) : chunk_size;
+            cmd_params.wOffset = (uint16_t)position;
+            cmd_params.eDataOrMdata = eDATA;
+
+            cmd_resp.prgbBuffer = p_chunk;
+            cmd_resp.wBufferLength = chunk_size;
+            cmd_resp.wRespLength = 0;
+
+            while (pal_os_lock_acquire() != PAL_STATUS_SUCCESS);
+            status = optiga_util_get_data_object(&cmd_params,&cmd_resp);
+            pal_os_lock_release();
+            if(CMD_LIB_OK != status)
+            {
+                // The previous chunk ended exactly at the end of the data object
+                if((0 != total_length) && (DEVICE_ERROR_OUT_OF_BOUND == status))
+                {
+                    status = OPTIGA_LIB_SUCCESS;
+                }
+                break;
+            }
+
+            status = sink(p_ctx, (uint16_t)position, p_chunk, cmd_resp.wRespLength);
+            if(OPTIGA_LIB_SUCCESS != status)
+            {
+                break;
+            }
+            total_length += cmd_resp.wRespLength;
+            position += cmd_resp.wRespLength;
+
+            // End of the data object
+            if(cmd_resp.wRespLength < cmd_params.wLength)
+            {
+                break;
+            }
+        }
+    }while(FALSE);
+
+    CmdLib_PutApduBuffer(p_chunk);
+    if(NULL != p_total_length)
+    {
+        *p_total_length = total_length;
+    }
+    return status;
+}
+
 optiga_lib_status_t optiga_util_read_metadata(uint16_t optiga_oid, uint8_t * p_buffer, uint16_t* buffer_size)
 {
     int32_t status  = (int32_t)OPTIGA_LIB_ERROR;
@@ -153,7 +927,9 @@ optiga_lib_status_t optiga_util_read_metadata(uint16_t optiga_oid, uint8_t * p_b
         cmd_resp.wBufferLength = buffer_limit;
         cmd_resp.wRespLength = 0;
 
-        status = CmdLib_GetDataObject(&cmd_params,&cmd_resp);
+        while (pal_os_lock_acquire() != PAL_STATUS_SUCCESS);
+        status = optiga_util_get_data_object(&cmd_params,&cmd_resp);
+        pal_os_lock_release();
         if(CMD_LIB_OK != status)
         {
             break;
@@ -200,7 +976,11 @@ optiga_lib_status_t optiga_util_write_data(uint16_t optiga_oid, uint8_t write_ty
         sd_params.prgbData = p_buffer;
         sd_params.wLength = buffer_size;
 
+        while (pal_os_lock_acquire() != PAL_STATUS_SUCCESS);
         status = CmdLib_SetDataObject(&sd_params);
+        // Also on failure, the write might have been partially executed
+        optiga_util_invalidate_object(optiga_oid);
+        pal_os_lock_release();
         if(CMD_LIB_OK != status)
         {
             break;
@@ -211,6 +991,81 @@ optiga_lib_status_t optiga_util_write_data(uint16_t optiga_oid, uint8_t write_ty
     return status;
 }
 
+optiga_lib_status_t optiga_util_write_data_stream(uint16_t optiga_oid, uint8_t write_type, uint16_t offset,
+                                                  optiga_util_write_source_t source, void * p_ctx)
+{
+    int32_t status  = (int32_t)OPTIGA_LIB_ERROR;
+    sSetData_d sd_params;
+    uint8_t * p_chunk = NULL;
+    uint16_t chunk_size;
+    uint16_t chunk_length;
+    uint32_t position = offset;
+
+    do
+    {
+        if(NULL == source)
+        {
+            status = OPTIGA_UTIL_ERROR_INVALID_INPUT;
+            break;
+        }
+        if ((OPTIGA_UTIL_WRITE_ONLY != write_type) && (OPTIGA_UTIL_ERASE_AND_WRITE != write_type))
+        {
+            status = OPTIGA_UTIL_ERROR_INVALID_INPUT;
+            break;
+        }
+        chunk_size = optiga_util_chunk_size(WRITE_CHUNK_OVERHEAD);
+        if(0 == chunk_size)
+        {
+            break;
+        }
+        p_chunk = CmdLib_GetApduBuffer(chunk_size);
+        if(NULL == p_chunk)
+        {
+            status = OPTIGA_UTIL_ERROR_MEMORY_INSUFFICIENT;
+            break;
+        }
+
+        sd_params.wOID = optiga_oid;
+        sd_params.eDataOrMdata = eDATA;
+        sd_params.prgbData = p_chunk;
+        // Only the first chunk may erase the data object
+        sd_params.eWriteOption = (OPTIGA_UTIL_ERASE_AND_WRITE == write_type) ? eERASE_AND_WRITE : eWRITE;
+
+        for(;;)
+        {
+            chunk_length = chunk_size;
+            status = source(p_ctx, (uint16_t)position, p_chunk, &chunk_length);
+            if((OPTIGA_LIB_SUCCESS != status) || (0 == chunk_length))
+            {
+                break;
+            }
+            if((chunk_length > chunk_size) || ((position + chunk_length) > 0xFFFF))
+            {
+                status = OPTIGA_UTIL_ERROR_INVALID_INPUT;
+                break;
+            }
+
+            sd_params.wOffset = (uint16_t)position;
+            sd_params.wLength = chunk_length;
+
+            while (pal_os_lock_acquire() != PAL_STATUS_SUCCESS);
+            status = CmdLib_SetDataObject(&sd_params);
+            optiga_util_invalidate_object(optiga_oid);
+            pal_os_lock_release();
+            if(CMD_LIB_OK != status)
+            {
+                break;
+            }
+            status = OPTIGA_LIB_SUCCESS;
+            position += chunk_length;
+            sd_params.eWriteOption = eWRITE;
+        }
+    }while(FALSE);
+
+    CmdLib_PutApduBuffer(p_chunk);
+    return status;
+}
+
 optiga_lib_status_t optiga_util_write_metadata(uint16_t optiga_oid, uint8_t * p_buffer, uint8_t buffer_size)
 {
 
@@ -225,7 +1080,11 @@ optiga_lib_status_t optiga_util_write_metadata(uint16_t optiga_oid, uint8_t * p_
     sd_params.prgbData = p_buffer;
     sd_params.wLength = buffer_size;
 
+    while (pal_os_lock_acquire() != PAL_STATUS_SUCCESS);
     status = CmdLib_SetDataObject(&sd_params);
+    // Changed access conditions apply to the cached copies as well
+    optiga_util_invalidate_object(optiga_oid);
+    pal_os_lock_release();
     if(CMD_LIB_OK != status)
     {
         return  status;
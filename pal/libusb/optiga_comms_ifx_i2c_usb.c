@@ -40,6 +40,7 @@
 #include "optiga/comms/optiga_comms.h"
 #include "optiga/ifx_i2c/ifx_i2c.h"
 #include "optiga/pal/pal_os_event.h"
+#include "optiga/pal/pal_os_timer.h"
 #include "pal_usb.h"
 
 /// @cond hidden
@@ -65,6 +66,7 @@
  *********************************************************************************************************************/
 static host_lib_status_t check_optiga_comms_state(optiga_comms_t *p_ctx);
 static void ifx_i2c_event_handler(void* upper_layer_ctx, host_lib_status_t event);
+static void ifx_i2c_queue_event_handler(void* upper_layer_ctx, host_lib_status_t event);
 
 uint16_t completion_status;
 
@@ -269,6 +271,199 @@ host_lib_status_t optiga_comms_transceive(optiga_comms_t *p_ctx,const uint8_t* p
     return status;
 }
 
+/**
+ * Sends a command gathered from segments to OPTIGA and scatters the response over segments.<br>
+ *
+ *
+ *<b>Pre Conditions:</b>
+ * - Communication channel must be established with OPTIGA.<br>
+ *
+ *<b>API Details:</b>
+ * - Transmit data(Command) to OPTIGA. The command is the concatenation of the transmit segments.<br>
+ * - Receive data(Response) from OPTIGA. The response is copied over the receive segments in order.<br>
+ *<br>
+ *
+ *<b>User Input:</b><br>
+ * - The input #optiga_comms_t p_ctx must not be NULL.<br>
+ * - The parameters in #optiga_comms_t must be initialized as for #optiga_comms_transceive().<br>
+ *
+ *<b>Notes:</b>
+ * - The first transmit segment must contain at least the command byte.<br>
+ * - If the total length of the receive segments is insufficient to copy the response bytes then
+ *   #IFX_I2C_STACK_MEM_ERROR error is returned.
+ *
+ *
+ * \param[in,out] p_ctx              Pointer to #optiga_comms_t
+ * \param[in]     p_tx_segments      Pointer to the write data segments
+ * \param[in]     tx_segment_count   Number of write data segments
+ * \param[in]     p_rx_segments      Pointer to the receive data segments
+ * \param[in]     rx_segment_count   Number of receive data segments
+ * \param[out]    p_rx_length        Pointer to the number of bytes received
+ *
+ * \retval  #OPTIGA_COMMS_SUCCESS
+ * \retval  #OPTIGA_COMMS_ERROR
+ * \retval  #IFX_I2C_STACK_MEM_ERROR
+ */
+host_lib_status_t optiga_comms_transceive_sg(optiga_comms_t *p_ctx,
+                                             const sbBlob_d* p_tx_segments, uint8_t tx_segment_count,
+                                             const sbBlob_d* p_rx_segments, uint8_t rx_segment_count,
+                                             uint16_t* p_rx_length)
+{
+    host_lib_status_t status = OPTIGA_COMMS_ERROR;
+    if (OPTIGA_COMMS_SUCCESS == check_optiga_comms_state(p_ctx))
+    {
+        ((ifx_i2c_context_t*)(p_ctx->comms_ctx))->p_upper_layer_ctx = (void*)p_ctx;
+        ((ifx_i2c_context_t*)(p_ctx->comms_ctx))->upper_layer_event_handler = ifx_i2c_event_handler;
+
+        completion_status = OPTIGA_COMMS_BUSY;
+
+        status = ifx_i2c_transceive_sg((ifx_i2c_context_t*)(p_ctx->comms_ctx),p_tx_segments,tx_segment_count,
+                                       p_rx_segments,rx_segment_count,p_rx_length);
+        if (IFX_I2C_STACK_SUCCESS != status)
+        {
+            p_ctx->state = OPTIGA_COMMS_FREE;
+            return status;
+        }
+        do
+        {
+            pal_os_event_trigger_registered_callback();
+        }while(completion_status == OPTIGA_COMMS_BUSY);
+
+        status = completion_status;
+    }
+    return status;
+}
+
+/**
+ * Queues a request to be sent to OPTIGA.<br>
+ *
+ *
+ *<b>Pre Conditions:</b>
+ * - Communication channel must be established with OPTIGA.<br>
+ *
+ *<b>API Details:</b>
+ * - The USB bridge is driven synchronously. The queue is drained within the call which finds the channel free,
+ *   requests submitted from a handler are sent after the current one.<br>
+ * - The handler of each request is invoked with p_handler_ctx and the completion status.<br>
+ *<br>
+ *
+ *<b>User Input:</b><br>
+ * - The input #optiga_comms_t p_ctx must not be NULL.<br>
+ * - The segments of p_request must be set as for #optiga_comms_transceive_sg().<br>
+ *
+ * \param[in,out] p_ctx             Pointer to #optiga_comms_t
+ * \param[in,out] p_request         Pointer to the request
+ *
+ * \retval  #OPTIGA_COMMS_SUCCESS
+ * \retval  #OPTIGA_COMMS_ERROR
+ */
+host_lib_status_t optiga_comms_submit(optiga_comms_t *p_ctx, optiga_comms_request_t* p_request)
+{
+    host_lib_status_t status;
+    uint32_t elapsed;
+
+    if ((NULL == p_ctx) || (NULL == p_request) || (NULL == p_request->p_tx_segments) || 
+        (0 == p_request->tx_segment_count))
+    {
+        return OPTIGA_COMMS_ERROR;
+    }
+    p_request->rx_length = 0;
+    p_request->p_next = NULL;
+    p_request->submit_time = pal_os_timer_get_time_in_milliseconds();
+    if (NULL == p_ctx->p_queue_tail)
+    {
+        p_ctx->p_queue_head = p_request;
+    }
+    else
+    {
+        p_ctx->p_queue_tail->p_next = p_request;
+    }
+    p_ctx->p_queue_tail = p_request;
+    p_ctx->queue_stats.submitted_count++;
+    if (++p_ctx->queue_stats.depth > p_ctx->queue_stats.max_depth)
+    {
+        p_ctx->queue_stats.max_depth = p_ctx->queue_stats.depth;
+    }
+
+    while ((NULL != p_ctx->p_queue_head) && (OPTIGA_COMMS_SUCCESS == check_optiga_comms_state(p_ctx)))
+    {
+        p_request = p_ctx->p_queue_head;
+        p_request->start_time = pal_os_timer_get_time_in_milliseconds();
+        ((ifx_i2c_context_t*)(p_ctx->comms_ctx))->p_upper_layer_ctx = (void*)p_ctx;
+        ((ifx_i2c_context_t*)(p_ctx->comms_ctx))->upper_layer_event_handler = ifx_i2c_queue_event_handler;
+
+        completion_status = OPTIGA_COMMS_BUSY;
+        status = ifx_i2c_transceive_sg((ifx_i2c_context_t*)(p_ctx->comms_ctx),
+                                       p_request->p_tx_segments, p_request->tx_segment_count,
+                                       p_request->p_rx_segments, p_request->rx_segment_count,
+                                       &p_request->rx_length);
+        if (IFX_I2C_STACK_SUCCESS == status)
+        {
+            do
+            {
+                pal_os_event_trigger_registered_callback();
+            }while(completion_status == OPTIGA_COMMS_BUSY);
+            status = completion_status;
+        }
+        else
+        {
+            status = OPTIGA_COMMS_ERROR;
+        }
+        p_ctx->state = OPTIGA_COMMS_FREE;
+
+        // Remove the request from the queue and update the counters
+        p_ctx->p_queue_head = p_request->p_next;
+        if (NULL == p_ctx->p_queue_head)
+        {
+            p_ctx->p_queue_tail = NULL;
+        }
+        p_request->p_next = NULL;
+        p_request->complete_time = pal_os_timer_get_time_in_milliseconds();
+        p_ctx->queue_stats.depth--;
+        p_ctx->queue_stats.completed_count++;
+        if (OPTIGA_COMMS_SUCCESS != status)
+        {
+            p_ctx->queue_stats.error_count++;
+        }
+        elapsed = p_request->start_time - p_request->submit_time;
+        p_ctx->queue_stats.total_wait_time += elapsed;
+        if (elapsed > p_ctx->queue_stats.max_wait_time)
+        {
+            p_ctx->queue_stats.max_wait_time = elapsed;
+        }
+        elapsed = p_request->complete_time - p_request->submit_time;
+        p_ctx->queue_stats.total_latency += elapsed;
+        if (elapsed > p_ctx->queue_stats.max_latency)
+        {
+            p_ctx->queue_stats.max_latency = elapsed;
+        }
+        if (NULL != p_request->handler)
+        {
+            p_request->handler(p_request->p_handler_ctx, status);
+        }
+    }
+    return OPTIGA_COMMS_SUCCESS;
+}
+
+/**
+ * Reads the counters of the request queue.<br>
+ *
+ * \param[in]     p_ctx             Pointer to #optiga_comms_t
+ * \param[out]    p_stats           Pointer to the buffer receiving the counters
+ *
+ * \retval  #OPTIGA_COMMS_SUCCESS
+ * \retval  #OPTIGA_COMMS_ERROR
+ */
+host_lib_status_t optiga_comms_get_queue_stats(optiga_comms_t *p_ctx, optiga_comms_queue_stats_t* p_stats)
+{
+    if ((NULL == p_ctx) || (NULL == p_stats))
+    {
+        return OPTIGA_COMMS_ERROR;
+    }
+    *p_stats = p_ctx->queue_stats;
+    return OPTIGA_COMMS_SUCCESS;
+}
+
 /**
  * Closes the communication with OPTIGA.<br>
  *
@@ -335,6 +530,12 @@ static void ifx_i2c_event_handler(void* upper_layer_ctx, host_lib_status_t event
     ((optiga_comms_t*)upper_layer_ctx)->state = OPTIGA_COMMS_FREE;
 }
 
+//lint --e{715} suppress "The queued requests are completed by optiga_comms_submit"
+static void ifx_i2c_queue_event_handler(void* upper_layer_ctx, host_lib_status_t event)
+{
+    completion_status = event;
+}
+
 /// @endcond
 /**
 * @}
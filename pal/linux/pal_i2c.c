@@ -35,6 +35,7 @@
 */
 
 #include <linux/i2c-dev.h>
+#include <linux/i2c.h>
 #include <fcntl.h>
 #include <sys/ioctl.h>
 #include <unistd.h>
@@ -277,7 +278,58 @@ pal_status_t pal_i2c_read(pal_i2c_t* p_i2c_context , uint8_t* p_data , uint16_t
     return i2c_read_status;
 }
 
-   
+
+pal_status_t pal_i2c_write_read(pal_i2c_t* p_i2c_context, uint8_t* p_tx_data, uint16_t tx_length,
+                                uint8_t* p_rx_data, uint16_t rx_length)
+{
+    int32_t i2c_status = PAL_STATUS_FAILURE;
+    struct i2c_msg messages[2];
+    struct i2c_rdwr_ioctl_data transaction;
+	pal_linux_t *pal_linux;
+    LOG_HAL("[IFX-HAL]: I2C TX (%d) RX (%d)\n", tx_length, rx_length);
+
+	pal_linux = (pal_linux_t*) p_i2c_context->p_i2c_hw_config;
+    //Acquire the I2C bus before read/write
+    if (PAL_STATUS_SUCCESS == pal_i2c_acquire(p_i2c_context))
+    {
+        gp_pal_i2c_current_ctx = p_i2c_context;
+
+        // Write and read are sent as one transaction with a repeated start in between
+        messages[0].addr  = p_i2c_context->slave_address;
+        messages[0].flags = 0;
+        messages[0].len   = tx_length;
+        messages[0].buf   = p_tx_data;
+        messages[1].addr  = p_i2c_context->slave_address;
+        messages[1].flags = I2C_M_RD;
+        messages[1].len   = rx_length;
+        messages[1].buf   = p_rx_data;
+        transaction.msgs  = messages;
+        transaction.nmsgs = 2;
+
+		if (0 > ioctl(pal_linux->i2c_handle, I2C_RDWR, &transaction))
+		{
+    		LOG_HAL("[IFX-HAL]: I2C_RDWR ERROR\n.");
+            //lint --e{611} suppress "void* function pointer is type casted to app_event_handler_t  type"
+            ((app_event_handler_t )(p_i2c_context->upper_layer_event_handler))
+                                                       (p_i2c_context->upper_layer_ctx  , PAL_I2C_EVENT_ERROR);
+			//Release I2C Bus
+			pal_i2c_release((void *)p_i2c_context);
+		}
+		else
+        {
+			i2c_master_end_of_receive_callback();
+			i2c_status = PAL_STATUS_SUCCESS;
+        }
+    }
+    else
+    {
+        i2c_status = PAL_STATUS_I2C_BUSY;
+        //lint --e{611} suppress "void* function pointer is type casted to app_event_handler_t  type"
+        ((app_event_handler_t )(p_i2c_context->upper_layer_event_handler))
+                                                        (p_i2c_context->upper_layer_ctx  , PAL_I2C_EVENT_BUSY);
+    }
+    return i2c_status;
+}
 
 pal_status_t pal_i2c_set_bitrate(const pal_i2c_t* p_i2c_context , uint16_t bitrate)
 {
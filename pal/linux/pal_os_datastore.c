@@ -0,0 +1,173 @@
+/**
+* \copyright
+* MIT License
+*
+* Copyright (c) 2018 Infineon Technologies AG
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE
+*
+* \endcopyright
+*
+* \author Infineon Technologies AG
+*
+* \file pal_os_datastore.c
+*
+* \brief   This file implements the platform abstraction layer APIs for persistent datastores, using memory mapped files.
+*
+* \ingroup  grPAL
+* @{
+*/
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "optiga/pal/pal_os_datastore.h"
+
+/// Number of datastores mapped at the same time
+#define PAL_OS_DATASTORE_MAX    4
+
+/**
+ * @brief Mapped datastore. The file stays open for the lock, which is an flock on the file.
+ */
+typedef struct pal_os_datastore
+{
+    /// Address of the mapping, NULL if the entry is unused
+    void * p_memory;
+    /// Descriptor of the file
+    int fd;
+} pal_os_datastore_t;
+
+// Accessed by the callers of the datastore APIs, which are serialized by the PAL OS lock
+static pal_os_datastore_t pal_os_datastores[PAL_OS_DATASTORE_MAX];
+
+static pal_os_datastore_t * pal_os_datastore_find(const void * p_memory)
+{
+    uint8_t index;
+
+    for (index = 0; index < PAL_OS_DATASTORE_MAX; index++)
+    {
+        if (p_memory == pal_os_datastores[index].p_memory)
+        {
+            return &pal_os_datastores[index];
+        }
+    }
+    return NULL;
+}
+
+pal_status_t pal_os_datastore_map(const char_t * p_name, uint32_t size, void ** pp_memory)
+{
+    pal_status_t return_status = PAL_STATUS_FAILURE;
+    pal_os_datastore_t * p_datastore;
+    struct stat file_stat;
+    void * p_memory;
+    int fd;
+
+    p_datastore = pal_os_datastore_find(NULL);
+    if (NULL == p_datastore)
+    {
+        return return_status;
+    }
+
+    fd = open(p_name, O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+    if (fd < 0)
+    {
+        return return_status;
+    }
+
+    do
+    {
+        if (0 != fstat(fd, &file_stat))
+        {
+            break;
+        }
+        // A new (or shorter) file is extended with zeros
+        if (((uint64_t)file_stat.st_size < size) && (0 != ftruncate(fd, size)))
+        {
+            break;
+        }
+        p_memory = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (MAP_FAILED == p_memory)
+        {
+            break;
+        }
+        p_datastore->p_memory = p_memory;
+        p_datastore->fd = fd;
+        *pp_memory = p_memory;
+        return_status = PAL_STATUS_SUCCESS;
+    } while (0);
+
+    if (PAL_STATUS_SUCCESS != return_status)
+    {
+        close(fd);
+    }
+    return return_status;
+}
+
+void pal_os_datastore_sync(void * p_memory, uint32_t size)
+{
+    (void)msync(p_memory, size, MS_ASYNC);
+}
+
+void pal_os_datastore_unmap(void * p_memory, uint32_t size)
+{
+    pal_os_datastore_t * p_datastore = pal_os_datastore_find(p_memory);
+
+    (void)munmap(p_memory, size);
+    if (NULL != p_datastore)
+    {
+        // Also drops a lock still held
+        close(p_datastore->fd);
+        p_datastore->p_memory = NULL;
+    }
+}
+
+pal_status_t pal_os_datastore_lock(void * p_memory)
+{
+    pal_os_datastore_t * p_datastore = pal_os_datastore_find(p_memory);
+
+    if ((NULL == p_memory) || (NULL == p_datastore))
+    {
+        return PAL_STATUS_FAILURE;
+    }
+    while (0 != flock(p_datastore->fd, LOCK_EX))
+    {
+        if (EINTR != errno)
+        {
+            return PAL_STATUS_FAILURE;
+        }
+    }
+    return PAL_STATUS_SUCCESS;
+}
+
+void pal_os_datastore_unlock(void * p_memory)
+{
+    pal_os_datastore_t * p_datastore = pal_os_datastore_find(p_memory);
+
+    if ((NULL != p_memory) && (NULL != p_datastore))
+    {
+        (void)flock(p_datastore->fd, LOCK_UN);
+    }
+}
+
+/**
+* @}
+*/
@@ -34,20 +34,63 @@
 * @{
 */
 
+
+#include <errno.h>
 #include <stdlib.h>
 #include <stdint.h>
+#include <string.h>
 #include <unistd.h>
 #include <stdio.h>
-#include <signal.h>
+#include <pthread.h>
 #include <time.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include "optiga/pal/pal_os_config.h"
+
+#if !defined(PAL_OS_HAS_EVENT_INIT) || !defined(PAL_OS_HAS_EVENT_CANCEL)
+#warning "PAL_OS_CONFIG_FILE lacks switches implemented here, the library will not use them"
+#ifndef PAL_OS_HAS_EVENT_INIT
+#define PAL_OS_HAS_EVENT_INIT
+#endif
+#ifndef PAL_OS_HAS_EVENT_CANCEL
+#define PAL_OS_HAS_EVENT_CANCEL
+#endif
+#endif
+
 #include "optiga/pal/pal_os_timer.h"
 #include "optiga/pal/pal_os_event.h"
 
 #include "pal_linux.h"
 
+#if IFX_I2C_LOG_PAL == 1
+#define LOG(...)  printf(__VA_ARGS__)
+#else
+#define LOG(...)
+#endif
+
+#define ERR(...)  fprintf(stderr, __VA_ARGS__)
+#define LOG_PREFIX "[IFX-PAL-OS-EVENT] "
+
+/// Maximum number of one shot timers pending at the same time
+#ifndef PAL_OS_EVENT_MAX_TIMERS
+#define PAL_OS_EVENT_MAX_TIMERS         16
+#endif
+
+/// Number of buckets of the timer wheel
+#ifndef PAL_OS_EVENT_WHEEL_SIZE
+#define PAL_OS_EVENT_WHEEL_SIZE         256
+#endif
+
+/// Time covered by one bucket of the timer wheel in microseconds
+#ifndef PAL_OS_EVENT_WHEEL_TICK_US
+#define PAL_OS_EVENT_WHEEL_TICK_US      100
+#endif
 
-#define CLOCKID CLOCK_REALTIME
-#define SIG SIGRTMIN
+/// @cond hidden
+#define PAL_OS_EVENT_TICK(time_us)      ((time_us) / PAL_OS_EVENT_WHEEL_TICK_US)
+#define PAL_OS_EVENT_BUCKET(tick)       ((tick) % PAL_OS_EVENT_WHEEL_SIZE)
+/// @endcond
 
 /** \brief PAL os event structure */
 typedef struct pal_os_event
@@ -56,88 +99,418 @@ typedef struct pal_os_event
     register_callback callback_registered;
     /// context to be passed to callback
     void * callback_ctx;
+    /// absolute expiry time (CLOCK_MONOTONIC) in microseconds
+    uint64_t expiry_us;
+    /// next timer in the same wheel bucket
+    struct pal_os_event * p_next;
+    /// 1 if the timer is pending
+    uint8_t in_use;
 }pal_os_event_t;
 
-static pal_os_event_t pal_os_event_0 = {0};
-static 	timer_t timerid;
+/** \brief Event thread and timer wheel */
+typedef struct pal_os_event_scheduler
+{
+    /// protects the timer pool and the wheel
+    pthread_mutex_t mutex;
+    /// event thread, runs all the registered callbacks
+    pthread_t thread;
+    /// epoll instance waiting on timer_fd and stop_fd
+    int epoll_fd;
+    /// timerfd armed to the earliest pending expiry
+    int timer_fd;
+    /// eventfd used to stop the event thread
+    int stop_fd;
+    /// 1 once the event thread is running
+    uint8_t running;
+    /// wheel tick processed last, all the buckets before are empty for the current lap
+    uint64_t current_tick;
+    /// timer pool
+    pal_os_event_t timers[PAL_OS_EVENT_MAX_TIMERS];
+    /// timer wheel buckets
+    pal_os_event_t * wheel[PAL_OS_EVENT_WHEEL_SIZE];
+}pal_os_event_scheduler_t;
+
+static pal_os_event_scheduler_t pal_os_event_0 = {.mutex = PTHREAD_MUTEX_INITIALIZER,
+                                                  .epoll_fd = -1, .timer_fd = -1, .stop_fd = -1};
+
+static uint64_t pal_os_event_time_in_us(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return ((uint64_t)now.tv_sec * 1000000) + ((uint64_t)now.tv_nsec / 1000);
+}
+
+static void pal_os_event_unlink(pal_os_event_t * p_timer)
+{
+    pal_os_event_t ** pp_node = &pal_os_event_0.wheel[PAL_OS_EVENT_BUCKET(PAL_OS_EVENT_TICK(p_timer->expiry_us))];
 
-static void handler(int sig, siginfo_t *si, void *uc)
+    while (NULL != *pp_node)
+    {
+        if (*pp_node == p_timer)
+        {
+            *pp_node = p_timer->p_next;
+            break;
+        }
+        pp_node = &((*pp_node)->p_next);
+    }
+    p_timer->p_next = NULL;
+    p_timer->in_use = 0;
+}
+
+static pal_os_event_t * pal_os_event_find(void * callback_args)
 {
-	register_callback callback;
-	
-	if (pal_os_event_0.callback_registered)
+    uint16_t index;
+
+    for (index = 0; index < PAL_OS_EVENT_MAX_TIMERS; index++)
     {
-        callback = pal_os_event_0.callback_registered;
-        pal_os_event_0.callback_registered = NULL;
-        callback((void * )pal_os_event_0.callback_ctx);
+        if ((pal_os_event_0.timers[index].in_use) && (pal_os_event_0.timers[index].callback_ctx == callback_args))
+        {
+            return &pal_os_event_0.timers[index];
+        }
     }
+    return NULL;
+}
+
+/*
+ * Arms the timerfd to the earliest pending expiry, or disarms it if nothing is pending.
+ * Walks the wheel from the current tick for one lap, timers of later laps are only considered
+ * if the lap is empty. Must be called with the mutex held.
+ */
+static void pal_os_event_arm(void)
+{
+    struct itimerspec its;
+    pal_os_event_t * p_timer;
+    uint64_t next_expiry_us = 0;
+    uint64_t tick;
+    uint16_t index;
+
+    for (tick = pal_os_event_0.current_tick;
+         (0 == next_expiry_us) && (tick < pal_os_event_0.current_tick + PAL_OS_EVENT_WHEEL_SIZE); tick++)
+    {
+        for (p_timer = pal_os_event_0.wheel[PAL_OS_EVENT_BUCKET(tick)]; NULL != p_timer; p_timer = p_timer->p_next)
+        {
+            if ((PAL_OS_EVENT_TICK(p_timer->expiry_us) <= tick) &&
+                ((0 == next_expiry_us) || (p_timer->expiry_us < next_expiry_us)))
+            {
+                next_expiry_us = p_timer->expiry_us;
+            }
+        }
+    }
+
+    if (0 == next_expiry_us)
+    {
+        for (index = 0; index < PAL_OS_EVENT_MAX_TIMERS; index++)
+        {
+            p_timer = &pal_os_event_0.timers[index];
+            if ((p_timer->in_use) && ((0 == next_expiry_us) || (p_timer->expiry_us < next_expiry_us)))
+            {
+                next_expiry_us = p_timer->expiry_us;
+            }
+        }
+    }
+
+    // A zero it_value disarms the timer
+    memset(&its, 0, sizeof(its));
+    if (0 != next_expiry_us)
+    {
+        its.it_value.tv_sec = (time_t)(next_expiry_us / 1000000);
+        its.it_value.tv_nsec = (long)((next_expiry_us % 1000000) * 1000);
+    }
+    if (-1 == timerfd_settime(pal_os_event_0.timer_fd, TFD_TIMER_ABSTIME, &its, NULL))
+    {
+        ERR(LOG_PREFIX "timerfd_settime failed (%d)\n", errno);
+    }
+}
+
+/*
+ * Collects the expired timers in expiry order and invokes their callbacks.
+ * The callbacks run without the mutex held so they can register the next timer.
+ */
+static void pal_os_event_process_expired(void)
+{
+    pal_os_event_t due[PAL_OS_EVENT_MAX_TIMERS];
+    pal_os_event_t ** pp_node;
+    pal_os_event_t * p_timer;
+    uint16_t due_count = 0;
+    uint16_t index;
+    uint64_t now_us;
+    uint64_t now_tick;
+    uint64_t tick;
+    uint64_t last_tick;
+
+    pthread_mutex_lock(&pal_os_event_0.mutex);
+    now_us = pal_os_event_time_in_us();
+    now_tick = PAL_OS_EVENT_TICK(now_us);
+    last_tick = now_tick;
+    if (now_tick - pal_os_event_0.current_tick >= PAL_OS_EVENT_WHEEL_SIZE)
+    {
+        last_tick = pal_os_event_0.current_tick + PAL_OS_EVENT_WHEEL_SIZE - 1;
+    }
+
+    for (tick = pal_os_event_0.current_tick; tick <= last_tick; tick++)
+    {
+        pp_node = &pal_os_event_0.wheel[PAL_OS_EVENT_BUCKET(tick)];
+        while (NULL != *pp_node)
+        {
+            p_timer = *pp_node;
+            if (p_timer->expiry_us > now_us)
+            {
+                pp_node = &p_timer->p_next;
+                continue;
+            }
+            *pp_node = p_timer->p_next;
+            p_timer->p_next = NULL;
+            p_timer->in_use = 0;
+
+            // Insertion sort by expiry, the list is short
+            index = due_count++;
+            while ((index > 0) && (due[index - 1].expiry_us > p_timer->expiry_us))
+            {
+                due[index] = due[index - 1];
+                index--;
+            }
+            due[index] = *p_timer;
+        }
+    }
+    pal_os_event_0.current_tick = now_tick;
+    pal_os_event_arm();
+    pthread_mutex_unlock(&pal_os_event_0.mutex);
+
+    for (index = 0; index < due_count; index++)
+    {
+        due[index].callback_registered(due[index].callback_ctx);
+    }
+}
+
+static void * pal_os_event_thread(void * arg)
+{
+    struct epoll_event events[2];
+    uint64_t value;
+    int count;
+    int index;
+
+    (void)arg;
+    for (;;)
+    {
+        count = epoll_wait(pal_os_event_0.epoll_fd, events, 2, -1);
+        if (-1 == count)
+        {
+            if (EINTR == errno)
+            {
+                continue;
+            }
+            ERR(LOG_PREFIX "epoll_wait failed (%d), event thread stopped\n", errno);
+            break;
+        }
+        for (index = 0; index < count; index++)
+        {
+            if (events[index].data.fd == pal_os_event_0.stop_fd)
+            {
+                return NULL;
+            }
+            // Drain the expiration count, the wheel itself tells what expired
+            (void)read(pal_os_event_0.timer_fd, &value, sizeof(value));
+        }
+        pal_os_event_process_expired();
+    }
+    return NULL;
+}
+
+static void pal_os_event_close_fds(void)
+{
+    if (-1 != pal_os_event_0.epoll_fd)
+    {
+        close(pal_os_event_0.epoll_fd);
+        pal_os_event_0.epoll_fd = -1;
+    }
+    if (-1 != pal_os_event_0.timer_fd)
+    {
+        close(pal_os_event_0.timer_fd);
+        pal_os_event_0.timer_fd = -1;
+    }
+    if (-1 != pal_os_event_0.stop_fd)
+    {
+        close(pal_os_event_0.stop_fd);
+        pal_os_event_0.stop_fd = -1;
+    }
+}
+
+static pal_status_t pal_os_event_start(void)
+{
+    pal_status_t return_status = PAL_STATUS_FAILURE;
+    struct epoll_event event;
+
+    do
+    {
+        if (pal_os_event_0.running)
+        {
+            return_status = PAL_STATUS_SUCCESS;
+            break;
+        }
+
+        pal_os_event_0.epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+        pal_os_event_0.timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+        pal_os_event_0.stop_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if ((-1 == pal_os_event_0.epoll_fd) || (-1 == pal_os_event_0.timer_fd) || (-1 == pal_os_event_0.stop_fd))
+        {
+            ERR(LOG_PREFIX "failed to create the event descriptors (%d)\n", errno);
+            break;
+        }
+
+        memset(&event, 0, sizeof(event));
+        event.events = EPOLLIN;
+        event.data.fd = pal_os_event_0.timer_fd;
+        if (-1 == epoll_ctl(pal_os_event_0.epoll_fd, EPOLL_CTL_ADD, pal_os_event_0.timer_fd, &event))
+        {
+            ERR(LOG_PREFIX "epoll_ctl failed (%d)\n", errno);
+            break;
+        }
+        event.data.fd = pal_os_event_0.stop_fd;
+        if (-1 == epoll_ctl(pal_os_event_0.epoll_fd, EPOLL_CTL_ADD, pal_os_event_0.stop_fd, &event))
+        {
+            ERR(LOG_PREFIX "epoll_ctl failed (%d)\n", errno);
+            break;
+        }
+
+        memset(pal_os_event_0.timers, 0, sizeof(pal_os_event_0.timers));
+        memset(pal_os_event_0.wheel, 0, sizeof(pal_os_event_0.wheel));
+        pal_os_event_0.current_tick = PAL_OS_EVENT_TICK(pal_os_event_time_in_us());
+
+        if (0 != pthread_create(&pal_os_event_0.thread, NULL, pal_os_event_thread, NULL))
+        {
+            ERR(LOG_PREFIX "failed to create the event thread\n");
+            break;
+        }
+        pal_os_event_0.running = 1;
+        return_status = PAL_STATUS_SUCCESS;
+    } while (0);
+
+    if (PAL_STATUS_SUCCESS != return_status)
+    {
+        pal_os_event_close_fds();
+    }
+    return return_status;
 }
 
 pal_status_t pal_os_event_init(void)
 {
-	struct sigevent sev;
-	struct sigaction sa;
-	
-	/* Establishing handler for signal */
-	
-	sa.sa_flags = SA_SIGINFO;
-	sa.sa_sigaction = handler;
-	sigemptyset(&sa.sa_mask);
-	if (sigaction(SIG, &sa, NULL) == -1)
-	{
-		printf("sigaction\n");
-		exit(1);
-	}
-
-	/* Create the timer */
-
-	sev.sigev_notify = SIGEV_SIGNAL;
-	sev.sigev_signo = SIG;
-	sev.sigev_value.sival_ptr = &timerid;
-	if (timer_create(CLOCKID, &sev, &timerid) == -1)
-	{
-		printf("timer_create\n");
-		exit(1);
-	}
-	
-	return PAL_STATUS_SUCCESS;
+    pal_status_t return_status;
+
+    pthread_mutex_lock(&pal_os_event_0.mutex);
+    return_status = pal_os_event_start();
+    pthread_mutex_unlock(&pal_os_event_0.mutex);
+
+    return return_status;
 }
 
 pal_status_t pal_os_event_stop(void)
 {
-	if (timerid != 0)
-	{
-		timer_delete(timerid);
-	}
-	return PAL_STATUS_SUCCESS;
-}
+    uint64_t value = 1;
 
+    pthread_mutex_lock(&pal_os_event_0.mutex);
+    if (!pal_os_event_0.running)
+    {
+        pthread_mutex_unlock(&pal_os_event_0.mutex);
+        return PAL_STATUS_SUCCESS;
+    }
+    pal_os_event_0.running = 0;
+    (void)write(pal_os_event_0.stop_fd, &value, sizeof(value));
+    pthread_mutex_unlock(&pal_os_event_0.mutex);
 
+    // Stopping from a callback must not join the calling thread itself
+    if (!pthread_equal(pthread_self(), pal_os_event_0.thread))
+    {
+        pthread_join(pal_os_event_0.thread, NULL);
+    }
+    else
+    {
+        pthread_detach(pal_os_event_0.thread);
+    }
+
+    pthread_mutex_lock(&pal_os_event_0.mutex);
+    pal_os_event_close_fds();
+    memset(pal_os_event_0.timers, 0, sizeof(pal_os_event_0.timers));
+    memset(pal_os_event_0.wheel, 0, sizeof(pal_os_event_0.wheel));
+    pthread_mutex_unlock(&pal_os_event_0.mutex);
+
+    return PAL_STATUS_SUCCESS;
+}
+
+/*
+ * Each callback context has at most one pending timer, a new registration for the same
+ * callback_args replaces the pending one. This keeps the single slot behaviour per IFX I2C
+ * context while timers of different contexts run independently.
+ */
 void pal_os_event_register_callback_oneshot(register_callback callback, 
                                             void*             callback_args,
                                             uint32_t          time_us)
 {
-	struct itimerspec its;
-	long long freq_nanosecs;
-    pal_os_event_0.callback_registered = callback;
-    pal_os_event_0.callback_ctx = callback_args;
-	
-	/* Start the timer */
-
-	freq_nanosecs = time_us * 1000;
-	its.it_value.tv_sec = freq_nanosecs / 1000000000;
-	its.it_value.tv_nsec = freq_nanosecs % 1000000000;
-	its.it_interval.tv_sec = 0;
-	its.it_interval.tv_nsec = 0;
-	
-	if (timer_settime(timerid, 0, &its, NULL) == -1)
-	{
-		printf("Error in timer_settime\n");
-	    exit(1);
-	}
+    pal_os_event_t * p_timer;
+    uint64_t tick;
+    uint16_t index;
+
+    pthread_mutex_lock(&pal_os_event_0.mutex);
+    do
+    {
+        if (PAL_STATUS_SUCCESS != pal_os_event_start())
+        {
+            break;
+        }
+
+        p_timer = pal_os_event_find(callback_args);
+        if (NULL != p_timer)
+        {
+            pal_os_event_unlink(p_timer);
+        }
+        else
+        {
+            for (index = 0; index < PAL_OS_EVENT_MAX_TIMERS; index++)
+            {
+                if (!pal_os_event_0.timers[index].in_use)
+                {
+                    p_timer = &pal_os_event_0.timers[index];
+                    break;
+                }
+            }
+        }
+        if (NULL == p_timer)
+        {
+            ERR(LOG_PREFIX "no free timer, callback dropped\n");
+            break;
+        }
+
+        p_timer->callback_registered = callback;
+        p_timer->callback_ctx = callback_args;
+        p_timer->expiry_us = pal_os_event_time_in_us() + time_us;
+        p_timer->in_use = 1;
+
+        tick = PAL_OS_EVENT_TICK(p_timer->expiry_us);
+        p_timer->p_next = pal_os_event_0.wheel[PAL_OS_EVENT_BUCKET(tick)];
+        pal_os_event_0.wheel[PAL_OS_EVENT_BUCKET(tick)] = p_timer;
+
+        pal_os_event_arm();
+    } while (0);
+    pthread_mutex_unlock(&pal_os_event_0.mutex);
+}
+
+pal_status_t pal_os_event_cancel(void * callback_args)
+{
+    pal_status_t return_status = PAL_STATUS_FAILURE;
+    pal_os_event_t * p_timer;
+
+    pthread_mutex_lock(&pal_os_event_0.mutex);
+    p_timer = pal_os_event_find(callback_args);
+    if (NULL != p_timer)
+    {
+        pal_os_event_unlink(p_timer);
+        return_status = PAL_STATUS_SUCCESS;
+    }
+    pthread_mutex_unlock(&pal_os_event_0.mutex);
+
+    return return_status;
 }
 
 /**
 * @}
 */
-
@@ -30,40 +30,314 @@
 * @{
 */
 
+#include <errno.h>
+#include <string.h>
+#include <pthread.h>
+#include <time.h>
+#include "optiga/pal/pal_os_config.h"
+
+#if !defined(PAL_OS_HAS_LOCK_TIMEOUT) || !defined(PAL_OS_HAS_LOCK_STATS) || \
+    !defined(PAL_OS_HAS_CRITICAL_SECTION) || !defined(PAL_OS_HAS_NOTIFICATION)
+#warning "PAL_OS_CONFIG_FILE lacks switches implemented here, the library will not use them"
+#ifndef PAL_OS_HAS_LOCK_TIMEOUT
+#define PAL_OS_HAS_LOCK_TIMEOUT
+#endif
+#ifndef PAL_OS_HAS_LOCK_STATS
+#define PAL_OS_HAS_LOCK_STATS
+#endif
+#ifndef PAL_OS_HAS_CRITICAL_SECTION
+#define PAL_OS_HAS_CRITICAL_SECTION
+#endif
+#ifndef PAL_OS_HAS_NOTIFICATION
+#define PAL_OS_HAS_NOTIFICATION
+#endif
+#endif
+
 #include "optiga/pal/pal_os_lock.h"
 
+/**
+ * @brief Waiter queued on the PAL OS lock. Lives on the stack of the waiting thread.
+ */
+typedef struct pal_os_lock_waiter
+{
+    /// Signalled when the lock is handed over to this waiter
+    pthread_cond_t cond;
+    /// Set by the releasing thread once the lock is owned by this waiter
+    uint8_t granted;
+    /// Next waiter in FIFO order
+    struct pal_os_lock_waiter * p_next;
+} pal_os_lock_waiter_t;
+
 /**
  * @brief PAL OS lock structure. Might be extended if needed
  */
 typedef struct pal_os_lock
 {
+    /// Protects all the fields below
+    pthread_mutex_t mutex;
+    /// Lock state, 1 if held
     uint8_t lock;
+    /// Number of threads currently waiting
+    uint32_t waiters;
+    /// FIFO of waiters. On release the lock is handed to the head directly.
+    pal_os_lock_waiter_t * p_head;
+    pal_os_lock_waiter_t * p_tail;
+    /// Contention counters
+    pal_os_lock_stats_t stats;
 } pal_os_lock_t;
 
-volatile static pal_os_lock_t pal_os_lock = {.lock = 0};
+static pal_os_lock_t pal_os_lock = {.mutex = PTHREAD_MUTEX_INITIALIZER};
 
-pal_status_t pal_os_lock_acquire(void)
+/// Critical section for short updates of shared state, never held across blocking calls
+static pthread_mutex_t pal_os_critical_section = PTHREAD_MUTEX_INITIALIZER;
+
+/**
+ * @brief Binary semaphore used to wait for the completion of asynchronous operations
+ */
+typedef struct pal_os_notification
+{
+    /// Protects pending
+    pthread_mutex_t mutex;
+    /// Signalled on notify, uses CLOCK_MONOTONIC for the timed wait
+    pthread_cond_t cond;
+    /// Set by notify, cleared by the wait consuming it
+    uint8_t pending;
+} pal_os_notification_t;
+
+static pal_os_notification_t pal_os_notification = {.mutex = PTHREAD_MUTEX_INITIALIZER};
+static pthread_once_t pal_os_notification_once = PTHREAD_ONCE_INIT;
+
+static uint64_t pal_os_lock_time_in_us(void)
 {
-    pal_status_t return_status = PAL_STATUS_FAILURE;
+    struct timespec now;
 
-    if(!(pal_os_lock.lock))
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return ((uint64_t)now.tv_sec * 1000000) + ((uint64_t)now.tv_nsec / 1000);
+}
+
+static void pal_os_lock_remove_waiter(pal_os_lock_waiter_t * p_waiter)
+{
+    pal_os_lock_waiter_t * p_prev = NULL;
+    pal_os_lock_waiter_t * p_node = pal_os_lock.p_head;
+
+    while ((NULL != p_node) && (p_node != p_waiter))
     {
-    	pal_os_lock.lock++;
-        if(pal_os_lock.lock != 1)
+        p_prev = p_node;
+        p_node = p_node->p_next;
+    }
+    if (NULL == p_node)
+    {
+        return;
+    }
+    if (NULL == p_prev)
+    {
+        pal_os_lock.p_head = p_node->p_next;
+    }
+    else
+    {
+        p_prev->p_next = p_node->p_next;
+    }
+    if (pal_os_lock.p_tail == p_node)
+    {
+        pal_os_lock.p_tail = p_prev;
+    }
+}
+
+/*
+ * Acquires the lock, waiting in FIFO order behind earlier callers.
+ * A NULL p_deadline waits forever, otherwise the wait is bounded by the absolute CLOCK_MONOTONIC deadline.
+ */
+static pal_status_t pal_os_lock_acquire_until(const struct timespec * p_deadline)
+{
+    pal_status_t return_status = PAL_STATUS_SUCCESS;
+    pal_os_lock_waiter_t waiter;
+    pthread_condattr_t cond_attr;
+    uint64_t wait_start;
+    uint64_t wait_time;
+
+    pthread_mutex_lock(&pal_os_lock.mutex);
+    pal_os_lock.stats.acquire_count++;
+
+    if ((0 == pal_os_lock.lock) && (NULL == pal_os_lock.p_head))
+    {
+        pal_os_lock.lock = 1;
+        pthread_mutex_unlock(&pal_os_lock.mutex);
+        return return_status;
+    }
+
+    pal_os_lock.stats.contended_count++;
+    wait_start = pal_os_lock_time_in_us();
+
+    pthread_condattr_init(&cond_attr);
+    pthread_condattr_setclock(&cond_attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&waiter.cond, &cond_attr);
+    pthread_condattr_destroy(&cond_attr);
+    waiter.granted = 0;
+    waiter.p_next = NULL;
+
+    if (NULL == pal_os_lock.p_tail)
+    {
+        pal_os_lock.p_head = &waiter;
+    }
+    else
+    {
+        pal_os_lock.p_tail->p_next = &waiter;
+    }
+    pal_os_lock.p_tail = &waiter;
+    pal_os_lock.waiters++;
+    if (pal_os_lock.waiters > pal_os_lock.stats.max_waiters)
+    {
+        pal_os_lock.stats.max_waiters = pal_os_lock.waiters;
+    }
+
+    while (!waiter.granted)
+    {
+        if (NULL == p_deadline)
         {
-        	pal_os_lock.lock--;
+            pthread_cond_wait(&waiter.cond, &pal_os_lock.mutex);
         }
-        return_status = PAL_STATUS_SUCCESS;
+        else if ((ETIMEDOUT == pthread_cond_timedwait(&waiter.cond, &pal_os_lock.mutex, p_deadline)) &&
+                 (!waiter.granted))
+        {
+            pal_os_lock_remove_waiter(&waiter);
+            pal_os_lock.stats.timeout_count++;
+            return_status = PAL_STATUS_FAILURE;
+            break;
+        }
+    }
+    pal_os_lock.waiters--;
+
+    wait_time = pal_os_lock_time_in_us() - wait_start;
+    pal_os_lock.stats.total_wait_time_us += wait_time;
+    if (wait_time > pal_os_lock.stats.max_wait_time_us)
+    {
+        pal_os_lock.stats.max_wait_time_us = wait_time;
     }
+
+    pthread_mutex_unlock(&pal_os_lock.mutex);
+    pthread_cond_destroy(&waiter.cond);
+
     return return_status;
 }
 
+pal_status_t pal_os_lock_acquire(void)
+{
+    return pal_os_lock_acquire_until(NULL);
+}
+
+static void pal_os_lock_get_deadline(struct timespec * p_deadline, uint32_t timeout_ms)
+{
+    clock_gettime(CLOCK_MONOTONIC, p_deadline);
+    p_deadline->tv_sec += timeout_ms / 1000;
+    p_deadline->tv_nsec += (long)(timeout_ms % 1000) * 1000000;
+    if (p_deadline->tv_nsec >= 1000000000)
+    {
+        p_deadline->tv_sec++;
+        p_deadline->tv_nsec -= 1000000000;
+    }
+}
+
+pal_status_t pal_os_lock_acquire_timeout(uint32_t timeout_ms)
+{
+    struct timespec deadline;
+
+    pal_os_lock_get_deadline(&deadline, timeout_ms);
+    return pal_os_lock_acquire_until(&deadline);
+}
+
 void pal_os_lock_release(void)
 {
-    if(pal_os_lock.lock)
+    pal_os_lock_waiter_t * p_next;
+
+    pthread_mutex_lock(&pal_os_lock.mutex);
+    if (pal_os_lock.lock)
+    {
+        p_next = pal_os_lock.p_head;
+        if (NULL != p_next)
+        {
+            // Hand the lock over to the oldest waiter, the lock stays held
+            pal_os_lock.p_head = p_next->p_next;
+            if (NULL == pal_os_lock.p_head)
+            {
+                pal_os_lock.p_tail = NULL;
+            }
+            p_next->granted = 1;
+            pthread_cond_signal(&p_next->cond);
+        }
+        else
+        {
+            pal_os_lock.lock = 0;
+        }
+    }
+    pthread_mutex_unlock(&pal_os_lock.mutex);
+}
+
+void pal_os_lock_get_stats(pal_os_lock_stats_t * p_stats)
+{
+    pthread_mutex_lock(&pal_os_lock.mutex);
+    *p_stats = pal_os_lock.stats;
+    pthread_mutex_unlock(&pal_os_lock.mutex);
+}
+
+void pal_os_lock_reset_stats(void)
+{
+    pthread_mutex_lock(&pal_os_lock.mutex);
+    memset(&pal_os_lock.stats, 0, sizeof(pal_os_lock.stats));
+    pthread_mutex_unlock(&pal_os_lock.mutex);
+}
+
+void pal_os_lock_enter_critical_section(void)
+{
+    pthread_mutex_lock(&pal_os_critical_section);
+}
+
+void pal_os_lock_exit_critical_section(void)
+{
+    pthread_mutex_unlock(&pal_os_critical_section);
+}
+
+static void pal_os_notification_init(void)
+{
+    pthread_condattr_t cond_attr;
+
+    pthread_condattr_init(&cond_attr);
+    pthread_condattr_setclock(&cond_attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&pal_os_notification.cond, &cond_attr);
+    pthread_condattr_destroy(&cond_attr);
+}
+
+pal_status_t pal_os_lock_wait_for_notification(uint32_t timeout_ms)
+{
+    pal_status_t return_status = PAL_STATUS_SUCCESS;
+    struct timespec deadline;
+
+    pthread_once(&pal_os_notification_once, pal_os_notification_init);
+    pal_os_lock_get_deadline(&deadline, timeout_ms);
+
+    pthread_mutex_lock(&pal_os_notification.mutex);
+    while (!pal_os_notification.pending)
     {
-    	pal_os_lock.lock--;
+        if ((ETIMEDOUT == pthread_cond_timedwait(&pal_os_notification.cond, &pal_os_notification.mutex, &deadline)) &&
+            (!pal_os_notification.pending))
+        {
+            return_status = PAL_STATUS_FAILURE;
+            break;
+        }
     }
+    pal_os_notification.pending = 0;
+    pthread_mutex_unlock(&pal_os_notification.mutex);
+
+    return return_status;
+}
+
+void pal_os_lock_notify(void)
+{
+    pthread_once(&pal_os_notification_once, pal_os_notification_init);
+
+    pthread_mutex_lock(&pal_os_notification.mutex);
+    pal_os_notification.pending = 1;
+    pthread_cond_signal(&pal_os_notification.cond);
+    pthread_mutex_unlock(&pal_os_notification.mutex);
 }
 
 /**